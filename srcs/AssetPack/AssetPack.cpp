@@ -0,0 +1,227 @@
+/* this file contains the implementation of the AssetPack class */
+
+#include <AssetPack.hpp>
+
+const char AssetPack::mMagic[8] =
+	{'H', 'T', 'S', 'P', 'A', 'C', 'K', '1'};
+
+std::list<AssetPack> AssetPack::mPacks;
+
+std::map<AssetPack::ConstLocPtr, const AssetPack*>
+	AssetPack::mLocationPacks;
+
+AssetPack::AssetPack()
+	: mData()
+	, mSize()
+	, mEntryCount()
+	, mBucketCount()
+	, mBuckets()
+	, mEntries() {}
+
+void AssetPack::open(const Path& path) {
+
+	mPath = path;
+
+	const int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		throwInvalid("it can't be opened");
+
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) == -1 || S_ISREG(fileStat.st_mode) == 0
+		|| static_cast<size_t>(fileStat.st_size) < HEADER_SIZE) {
+		::close(fd);
+		throwInvalid("it's not a pack file");
+	}
+
+	mSize = fileStat.st_size;
+
+	void* mapping = mmap(NULL, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// the mapping stays valid once the descriptor is closed
+	::close(fd);
+
+	if (mapping == MAP_FAILED)
+		throwInvalid("it can't be mapped");
+
+	mData = static_cast<const char*>(mapping);
+
+	if (std::memcmp(mData, mMagic, sizeof(mMagic)))
+		throwInvalid("bad magic number");
+
+	mEntryCount = readUint32(mData + 8);
+	mBucketCount = readUint32(mData + 12);
+
+	const size_t bucketsOffset = readUint64(mData + 16);
+	const size_t entriesOffset = readUint64(mData + 24);
+
+	// the bucket count should be a power of 2 larger than the
+		// number of entries so that a probe always ends
+	if (readUint64(mData + 32) != mSize || mBucketCount == 0
+		|| (mBucketCount & (mBucketCount - 1))
+		|| mBucketCount <= mEntryCount
+		|| isInPack(bucketsOffset, mBucketCount * BUCKET_SIZE) == false
+		|| isInPack(entriesOffset, mEntryCount * ENTRY_SIZE) == false)
+		throwInvalid("corrupted index");
+
+	mBuckets = mData + bucketsOffset;
+	mEntries = mData + entriesOffset;
+
+	// the pointers of every entry are checked once
+		// so that find() can trust them
+	for (unsigned long index = 0; index < mEntryCount; ++index) {
+
+		const char* entry = mEntries + index * ENTRY_SIZE;
+
+		if (isInPack(readUint64(entry + 8), readUint32(entry + 4)) == false
+			|| isInPack(readUint64(entry + 16), readUint32(entry + 24)) == false
+			|| isInPack(readUint64(entry + 40), readUint64(entry + 48)) == false
+			|| isInPack(readUint64(entry + 56), readUint64(entry + 64)) == false)
+			throwInvalid("corrupted entry");
+
+	}
+
+	// the whole pack is served from memory so
+		// the kernel can start reading it now
+#ifdef MADV_WILLNEED
+	madvise(mapping, mSize, MADV_WILLNEED);
+#endif
+
+}
+
+bool AssetPack::find(const std::string& path, Entry& entry) const {
+
+	const unsigned long hash = hashPath(path.data(), path.size());
+
+	unsigned long bucket = hash & (mBucketCount - 1);
+
+	// linear probing from the bucket of the hash until an empty
+		// bucket is found (or all of them were visited which
+		// can only happen with a corrupted pack)
+	for (unsigned long probe = 0; probe < mBucketCount; ++probe,
+		bucket = (bucket + 1) & (mBucketCount - 1)) {
+
+		const unsigned long index =
+			readUint32(mBuckets + bucket * BUCKET_SIZE);
+
+		if (index == 0 || index > mEntryCount)
+			return false;
+
+		const char* record = mEntries + (index - 1) * ENTRY_SIZE;
+
+		if (readUint32(record) != hash
+			|| readUint32(record + 4) != path.size()
+			|| std::memcmp(mData + readUint64(record + 8),
+				path.data(), path.size()))
+			continue;
+
+		entry.type = mData + readUint64(record + 16);
+		entry.typeLength = readUint32(record + 24);
+		entry.modTime = static_cast<std::time_t>(readUint64(record + 32));
+		entry.data = mData + readUint64(record + 40);
+		entry.size = readUint64(record + 48);
+		entry.gzipSize = readUint64(record + 64);
+		entry.gzipData = entry.gzipSize
+			? mData + readUint64(record + 56) : NULL;
+
+		return true;
+
+	}
+
+	return false;
+
+}
+
+void AssetPack::load(const Servers& servers) {
+
+	// packs already mapped keyed by their path
+	std::map<Path, const AssetPack*> packs;
+
+	for (Servers::const_iterator server = servers.begin();
+		server != servers.end(); ++server) {
+
+		for (Config::LocationsCollection::const_iterator location
+			= server->locations.begin();
+			location != server->locations.end(); ++location) {
+
+			const Path& packPath = location->second.assetPack;
+
+			if (packPath.empty())
+				continue;
+
+			const AssetPack*& pack = packs[packPath];
+
+			if (pack == NULL) {
+				mPacks.push_back(AssetPack());
+				mPacks.back().open(packPath);
+				pack = &mPacks.back();
+			}
+
+			mLocationPacks[&location->second] = pack;
+
+		}
+
+	}
+
+}
+
+const AssetPack* AssetPack::get(ConstLocPtr location) {
+
+	// most locations don't use a pack
+	if (mLocationPacks.empty())
+		return NULL;
+
+	const std::map<ConstLocPtr, const AssetPack*>::const_iterator
+		pack = mLocationPacks.find(location);
+
+	return (pack == mLocationPacks.end() ? NULL : pack->second);
+
+}
+
+unsigned long AssetPack::hashPath(const char* path,
+	const size_t length) {
+
+	unsigned long hash = 2166136261UL;
+
+	for (size_t i = 0; i < length; ++i) {
+		hash ^= static_cast<unsigned char>(path[i]);
+		hash = (hash * 16777619UL) & 0xFFFFFFFFUL;
+	}
+
+	return hash;
+
+}
+
+unsigned long AssetPack::readUint32(const char* data) {
+
+	const unsigned char* bytes =
+		reinterpret_cast<const unsigned char*>(data);
+
+	return (static_cast<unsigned long>(bytes[0])
+		| static_cast<unsigned long>(bytes[1]) << 8
+		| static_cast<unsigned long>(bytes[2]) << 16
+		| static_cast<unsigned long>(bytes[3]) << 24);
+
+}
+
+size_t AssetPack::readUint64(const char* data) {
+
+	// the high half only matters on 64-bit systems where
+		// size_t can hold it (a larger pack can't be
+		// mapped on the others anyway)
+	size_t value = readUint32(data + 4);
+	value = (value << 16) << 16;
+
+	return (value | readUint32(data));
+
+}
+
+bool AssetPack::isInPack(const size_t offset, const size_t size) const {
+	return (offset <= mSize && size <= mSize - offset);
+}
+
+void AssetPack::throwInvalid(const std::string& reason) const {
+
+	throw std::runtime_error("asset pack '" + mPath
+		+ "' is invalid: " + reason);
+
+}
@@ -0,0 +1,135 @@
+/* this file contains the definition of the AssetPack class
+ * An asset pack is a single file that holds all the files of a
+ *  directory tree along with an index of their paths. It's built
+ *  offline by the asset-packer tool (see AssetPacker) and mapped
+ *  into memory at startup so that a location using the asset_pack
+ *  directive is served without any filesystem access: a path is
+ *  found with a probe in a hash table and the body is sent straight
+ *  from the mapping
+ * Layout of a pack (all the integers are little endian):
+ *  header: magic (8 bytes), number of entries (u32), number of
+ *   buckets (u32, a power of 2), offset of the buckets (u64), offset
+ *   of the entries (u64), size of the whole pack (u64)
+ *  buckets: index + 1 of an entry or 0 if the bucket is empty (u32)
+ *   the entries are placed with linear probing from the bucket
+ *   selected by the hash of their path
+ *  entries: hash of the path (u32), length of the path (u32), offset
+ *   of the path (u64), offset of the mime type (u64), length of the
+ *   mime type (u32), reserved (u32), modification time (u64),
+ *   offset and size of the content (u64, u64), offset and size of
+ *   its gzip variant (u64, u64, both 0 if there is none)
+ *  then the paths, mime types and contents that the entries point to
+ */
+
+#pragma once
+
+#include <string>
+#include <map>
+#include <list>
+#include <ctime>
+#include <stdexcept>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <Config.hpp>
+
+class AssetPack {
+
+	public:
+		/******* alias types *******/
+		typedef Config::Servers Servers;
+		typedef Config::ConstLocPtr ConstLocPtr;
+		typedef Config::Path Path;
+
+		/******* nested types *******/
+		// sizes of the parts of the pack format
+		enum {
+			HEADER_SIZE = 40,
+			BUCKET_SIZE = 4,
+			ENTRY_SIZE = 72
+		};
+
+		// a file of the pack
+		// its pointers refer to the mapping of the
+			// pack which stays valid for the whole program
+		struct Entry {
+			const char* data;
+			size_t size;
+			// NULL if there is no gzip variant
+			const char* gzipData;
+			size_t gzipSize;
+			const char* type;
+			size_t typeLength;
+			std::time_t modTime;
+		};
+
+		/******* public member functions *******/
+		AssetPack();
+
+		// maps the pack at path and checks its layout
+		// the pack is never unmapped since responses
+			// send their bodies straight from it
+		// throws std::runtime_error if it can't be
+			// mapped or it isn't a valid pack
+		void open(const Path& path);
+
+		// looks up path (relative to the root of the packed
+			// directory and starting with '/') and sets entry
+		// returns false if path isn't in the pack
+		bool find(const std::string& path, Entry& entry) const;
+
+		// maps the packs of all the locations using asset_pack
+			// (a pack shared by locations is mapped once)
+		// throws std::runtime_error if one of them is invalid
+		static void load(const Servers& servers);
+
+		// returns the pack served by location
+			// or NULL if it doesn't use one
+		static const AssetPack* get(ConstLocPtr location);
+
+		// hash of the length bytes of path used to place
+			// the entries in the buckets (32-bit FNV-1a)
+		static unsigned long hashPath(const char* path,
+			const size_t length);
+
+		// the 8 bytes that start a pack
+		static const char mMagic[8];
+
+	private:
+		/******* private member objects *******/
+		Path mPath;
+
+		// mapping of the whole pack
+		const char* mData;
+
+		size_t mSize;
+
+		unsigned long mEntryCount;
+
+		unsigned long mBucketCount;
+
+		// parts of the mapping
+		const char* mBuckets;
+		const char* mEntries;
+
+		// packs mapped by load()
+		static std::list<AssetPack> mPacks;
+
+		// pack of each location that uses one
+		static std::map<ConstLocPtr, const AssetPack*> mLocationPacks;
+
+		/******* private member functions *******/
+		// decodes the little endian integer at data
+		static unsigned long readUint32(const char* data);
+		static size_t readUint64(const char* data);
+
+		// returns true if the size bytes at offset are
+			// within the mapping
+		bool isInPack(const size_t offset, const size_t size) const;
+
+		// throws std::runtime_error about the pack being invalid
+		void throwInvalid(const std::string& reason) const;
+
+};
@@ -0,0 +1,288 @@
+/* this file contains the implementation of the AssetPacker class */
+
+#include <AssetPacker.hpp>
+
+const size_t AssetPacker::mCopySize = 65536;
+
+AssetPacker::AssetPacker(const MimeTypes& mimeTypes,
+	const bool isCompressing)
+	: mMimeTypes(mimeTypes)
+	, mIsCompressing(isCompressing) {}
+
+void AssetPacker::addDirectory(const std::string& rootDir) {
+
+	std::string dirPath = rootDir;
+	if (dirPath.empty() || dirPath[dirPath.size() - 1] != '/')
+		dirPath += '/';
+
+	addFiles(dirPath, "/");
+
+	// the pack is the same for the same tree
+	std::sort(mFiles.begin(), mFiles.end(), isPathLess);
+
+}
+
+void AssetPacker::write(const std::string& path) {
+
+	// a power of 2 at least twice the number of files
+		// keeps the probes short
+	unsigned long bucketCount = 1;
+	while (bucketCount < mFiles.size() * 2 + 1)
+		bucketCount <<= 1;
+
+	const size_t bucketsOffset = AssetPack::HEADER_SIZE;
+	const size_t entriesOffset =
+		bucketsOffset + bucketCount * AssetPack::BUCKET_SIZE;
+
+	// the paths and types follow the entries
+	std::string strings;
+	size_t offset = entriesOffset + mFiles.size() * AssetPack::ENTRY_SIZE;
+
+	for (std::vector<File>::iterator file = mFiles.begin();
+		file != mFiles.end(); ++file) {
+
+		file->pathOffset = offset + strings.size();
+		strings += file->path;
+		file->typeOffset = offset + strings.size();
+		strings += file->type;
+
+	}
+
+	// then the contents of the files
+	offset += strings.size();
+
+	for (std::vector<File>::iterator file = mFiles.begin();
+		file != mFiles.end(); ++file) {
+
+		file->dataOffset = offset;
+		offset += file->size;
+		file->gzipOffset = file->gzip.empty() ? 0 : offset;
+		offset += file->gzip.size();
+
+	}
+
+	const size_t packSize = offset;
+
+	std::vector<unsigned long> buckets(bucketCount, 0);
+	std::string index;
+
+	for (size_t i = 0; i < mFiles.size(); ++i) {
+
+		const File& file = mFiles[i];
+
+		const unsigned long hash =
+			AssetPack::hashPath(file.path.data(), file.path.size());
+
+		// linear probing until an empty bucket is found
+		unsigned long bucket = hash & (bucketCount - 1);
+		while (buckets[bucket])
+			bucket = (bucket + 1) & (bucketCount - 1);
+		buckets[bucket] = i + 1;
+
+		appendUint32(index, hash);
+		appendUint32(index, file.path.size());
+		appendUint64(index, file.pathOffset);
+		appendUint64(index, file.typeOffset);
+		appendUint32(index, file.type.size());
+		appendUint32(index, 0);
+		appendUint64(index, file.modTime);
+		appendUint64(index, file.dataOffset);
+		appendUint64(index, file.size);
+		appendUint64(index, file.gzipOffset);
+		appendUint64(index, file.gzip.size());
+
+	}
+
+	std::string header(AssetPack::mMagic, sizeof(AssetPack::mMagic));
+	appendUint32(header, mFiles.size());
+	appendUint32(header, bucketCount);
+	appendUint64(header, bucketsOffset);
+	appendUint64(header, entriesOffset);
+	appendUint64(header, packSize);
+
+	for (std::vector<unsigned long>::const_iterator bucket
+		= buckets.begin(); bucket != buckets.end(); ++bucket)
+		appendUint32(header, *bucket);
+
+	std::ofstream pack(path.c_str(),
+		std::ios::out | std::ios::binary | std::ios::trunc);
+
+	if (!pack)
+		throw std::runtime_error("can't create '" + path + '\'');
+
+	pack << header << index << strings;
+
+	// the contents are copied from the files while the
+		// pack is written so that they're never all in memory
+	std::vector<char> buffer(mCopySize);
+
+	for (std::vector<File>::const_iterator file = mFiles.begin();
+		file != mFiles.end(); ++file) {
+
+		std::ifstream input(file->fullPath.c_str(), std::ios::binary);
+
+		size_t bytesLeft = file->size;
+		while (input && bytesLeft) {
+
+			input.read(&buffer[0],
+				bytesLeft < mCopySize ? bytesLeft : mCopySize);
+			pack.write(&buffer[0], input.gcount());
+			bytesLeft -= input.gcount();
+
+		}
+
+		if (bytesLeft)
+			throw std::runtime_error("'" + file->fullPath
+				+ "' changed while it was packed");
+
+		pack << file->gzip;
+
+	}
+
+	if (!pack.flush())
+		throw std::runtime_error("can't write '" + path + '\'');
+
+}
+
+size_t AssetPacker::getFileCount() const {
+	return mFiles.size();
+}
+
+void AssetPacker::addFiles(const std::string& dirPath,
+	const std::string& packPath) {
+
+	DIR* dir = opendir(dirPath.c_str());
+	if (dir == NULL)
+		throw std::runtime_error("can't open directory '"
+			+ dirPath + '\'');
+
+	std::vector<std::string> subDirs;
+
+	for (struct dirent* element = readdir(dir); element;
+		element = readdir(dir)) {
+
+		const std::string name = element->d_name;
+
+		if (name == "." || name == "..")
+			continue;
+
+		File file;
+		file.fullPath = dirPath + name;
+		file.path = packPath + name;
+
+		struct stat fileStat;
+		if (stat(file.fullPath.c_str(), &fileStat) == -1) {
+			closedir(dir);
+			throw std::runtime_error("can't stat '"
+				+ file.fullPath + '\'');
+		}
+
+		// directories are walked once this one is closed
+		if (S_ISDIR(fileStat.st_mode)) {
+			subDirs.push_back(name);
+			continue;
+		}
+
+		if (S_ISREG(fileStat.st_mode) == 0)
+			continue;
+
+		file.modTime = fileStat.st_mtime;
+		file.size = fileStat.st_size;
+
+		setType(file);
+
+		if (mIsCompressing)
+			compress(file);
+
+		mFiles.push_back(file);
+
+	}
+
+	closedir(dir);
+
+	for (std::vector<std::string>::const_iterator subDir
+		= subDirs.begin(); subDir != subDirs.end(); ++subDir)
+		addFiles(dirPath + *subDir + '/', packPath + *subDir + '/');
+
+}
+
+void AssetPacker::setType(File& file) const {
+
+	const std::string::size_type extensionPos = file.path.rfind('.');
+	const std::string::size_type namePos = file.path.rfind('/');
+
+	// same lookup as the one made for the files served
+		// from the filesystem
+	const std::string extension =
+		(extensionPos != std::string::npos && extensionPos > namePos)
+		? file.path.substr(extensionPos + 1) : "";
+
+	file.type = mMimeTypes.getType(extension);
+
+}
+
+void AssetPacker::compress(File& file) const {
+
+	// types that are worth compressing
+	static const char* textTypes[] = {
+		"text/", "application/javascript", "application/json",
+		"application/xml", "image/svg+xml"
+	};
+
+	bool isText = false;
+	for (size_t i = 0; i < sizeof(textTypes) / sizeof(textTypes[0]); ++i)
+		if (file.type.compare(0, std::strlen(textTypes[i]),
+			textTypes[i]) == 0)
+			isText = true;
+
+	if (isText == false || file.size == 0)
+		return;
+
+	std::string content;
+	readFile(file, content);
+
+	GzipEncoder encoder;
+	encoder.start(9);
+	encoder.compress(content.data(), content.size(), file.gzip);
+	encoder.finish(file.gzip);
+
+	// the variant is only kept if it saves bytes
+	if (file.gzip.size() >= file.size)
+		std::string().swap(file.gzip);
+
+}
+
+void AssetPacker::readFile(const File& file, std::string& content) {
+
+	std::ifstream input(file.fullPath.c_str(), std::ios::binary);
+
+	content.resize(file.size);
+	if (file.size)
+		input.read(&content[0], file.size);
+
+	if (!input || static_cast<size_t>(input.gcount()) != file.size)
+		throw std::runtime_error("can't read '" + file.fullPath + '\'');
+
+}
+
+void AssetPacker::appendUint32(std::string& output,
+	const unsigned long value) {
+
+	for (int i = 0; i < 4; ++i)
+		output += static_cast<char>((value >> (i * 8)) & 0xFF);
+
+}
+
+void AssetPacker::appendUint64(std::string& output,
+	const size_t value) {
+
+	// shifted in two steps so that it's valid
+		// where size_t has 32 bits
+	appendUint32(output, value & 0xFFFFFFFFUL);
+	appendUint32(output, (value >> 16) >> 16);
+
+}
+
+bool AssetPacker::isPathLess(const File& first, const File& second) {
+	return (first.path < second.path);
+}
@@ -0,0 +1,108 @@
+/* this file contains the definition of the AssetPacker class
+ * It's used by the asset-packer tool to build an asset pack (see
+ *  AssetPack for its layout) from all the regular files of a
+ *  directory tree. The mime type of each file is resolved from its
+ *  extension when the pack is built, and text files can be stored
+ *  along with a variant compressed with gzip so that the server
+ *  never needs to compress them itself
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <ctime>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <AssetPack.hpp>
+#include <MimeTypes.hpp>
+#include <GzipEncoder.hpp>
+
+class AssetPacker {
+
+	public:
+		/******* public member functions *******/
+		// mimeTypes gives the type of the packed files from
+			// their extensions
+		// if isCompressing is set, a gzip variant is stored for
+			// the text files that are made smaller by it
+		AssetPacker(const MimeTypes& mimeTypes,
+			const bool isCompressing);
+
+		// adds all the regular files found under rootDir
+			// (following symbolic links) with their path
+			// relative to rootDir (like /css/style.css)
+		// throws std::runtime_error if a directory
+			// or a file can't be read
+		void addDirectory(const std::string& rootDir);
+
+		// writes the pack of the added files to path
+		// throws std::runtime_error on error
+		void write(const std::string& path);
+
+		// returns the number of added files
+		size_t getFileCount() const;
+
+	private:
+		/******* private nested types *******/
+		struct File {
+			// path within the pack
+			std::string path;
+			// path on the filesystem
+			std::string fullPath;
+			std::string type;
+			std::time_t modTime;
+			size_t size;
+			// empty if there is no gzip variant
+			std::string gzip;
+			// offsets of the path, type, content and
+				// gzip variant within the pack
+			size_t pathOffset;
+			size_t typeOffset;
+			size_t dataOffset;
+			size_t gzipOffset;
+		};
+
+		/******* private member objects *******/
+		const MimeTypes& mMimeTypes;
+
+		bool mIsCompressing;
+
+		std::vector<File> mFiles;
+
+		// amount of bytes copied at once from a
+			// packed file to the pack
+		static const size_t mCopySize;
+
+		/******* private member functions *******/
+		// adds the files of dirPath whose path
+			// within the pack starts with packPath
+		void addFiles(const std::string& dirPath,
+			const std::string& packPath);
+
+		// sets the mime type of file from
+			// the extension of its path
+		void setType(File& file) const;
+
+		// stores the gzip variant of file if its type is a
+			// text type and it's smaller than the file
+		void compress(File& file) const;
+
+		// reads the whole content of file into content
+		// throws std::runtime_error if its size changed
+		static void readFile(const File& file, std::string& content);
+
+		// appends value to output as a little endian integer
+		static void appendUint32(std::string& output,
+			const unsigned long value);
+		static void appendUint64(std::string& output,
+			const size_t value);
+
+		// used to sort the files by their path
+		static bool isPathLess(const File& first,
+			const File& second);
+
+};
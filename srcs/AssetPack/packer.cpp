@@ -0,0 +1,50 @@
+/* asset-packer: builds an asset pack from a directory tree
+ * usage: asset-packer [-z] <directory> <pack file> [mime types file]
+ *  -z stores a gzip variant of the text files
+ */
+
+#include <AssetPacker.hpp>
+#include <iostream>
+#include <cstdlib>
+
+int main(int ac, char** av) {
+
+	bool isCompressing = false;
+	int arg = 1;
+
+	if (arg < ac && std::string(av[arg]) == "-z") {
+		isCompressing = true;
+		++arg;
+	}
+
+	if (ac - arg < 2 || ac - arg > 3) {
+		std::cerr << "usage: " << av[0] << " [-z] <directory> "
+			"<pack file> [mime types file]\n";
+		exit(EXIT_FAILURE);
+	}
+
+	try {
+
+		// the server's default mime types are used
+			// if no file is passed
+		const MimeTypes mimeTypes(ac - arg == 3 ? av[arg + 2] : NULL);
+
+		AssetPacker packer(mimeTypes, isCompressing);
+		packer.addDirectory(av[arg]);
+		packer.write(av[arg + 1]);
+
+		std::cout << "packed " << packer.getFileCount()
+			<< " files into " << av[arg + 1] << '\n';
+
+	}
+	catch (const std::exception& error) {
+
+		std::cerr << "Exception: "
+			<< error.what() << '\n';
+		exit(EXIT_FAILURE);
+
+	}
+
+	exit(EXIT_SUCCESS);
+
+}
@@ -18,212 +18,459 @@ const std::string AutoIndex::mListingHtmlFooter
 	= "</tbody></table>"
 	"</body></html>";
 
-AutoIndex::AutoIndex(const std::string& dirPath, 
-	const std::string& listingFileOutputPath,
-	ConstLocPtr location)
-	: mListingFilePath(listingFileOutputPath) 
-	, mDirPath(dirPath)
-	, mLocation(location) {}
-
-void AutoIndex::generate() {
-	
-	// opens the output file that will contain
-		// the generated html
-	mListingStream.open(mListingFilePath.c_str(),  
-		std::ofstream::out | std::ofstream::trunc);
+const size_t AutoIndex::mDefaultPageLimit = 1000;
+
+const size_t AutoIndex::mMaxPageLimit = 10000;
+
+AutoIndex::AutoIndex()
+	: mLocation()
+	, mDir()
+	, mIsHeaderDone() {}
+
+AutoIndex::~AutoIndex() {
+	close();
+}
+
+void AutoIndex::open(const std::string& dirPath,
+	ConstLocPtr location) {
+
+	close();
+
+	mDirPath = dirPath;
+	mLocation = location;
+	mIsHeaderDone = false;
 
-	// file couldn't be opened
-	if (!mListingStream) {
+	mDir = opendir(mDirPath.c_str());
+
+	if (mDir == NULL) {
 
 		const std::string errorMsg =
-			std::string("generate(): couldn't open file: '")
-			+ mListingFilePath + '\'';
+			std::string("AutoIndex::open(): couldn't open dir: '")
+			+ mDirPath + '\'';
 		throw std::runtime_error(errorMsg);
 
 	}
-	
-	// writes the listing html header which contains
-		// the first structural html lines into
-		// the output file
-	mListingStream << mListingHtmlHeader;
-	if (mListingStream.fail()) {
-		throw std::runtime_error
-			("generate(): "
-			 "couldn't write to stream");
+
+}
+
+bool AutoIndex::generate(std::string& listing, const size_t size) {
+
+	if (mDir == NULL) {
+		throw std::runtime_error("AutoIndex::generate(): "
+			"no directory is open");
 	}
 
-	generateDirListing();
+	const size_t end = listing.size() + size;
 
-	// writes the listing html footer which contains
-		// the closing html tags into
-		// the output file
-	mListingStream << mListingHtmlFooter;
-	if (mListingStream.fail()) {
-		throw std::runtime_error
-			("generate(): "
-			 "couldn't write to stream");
+	// the listing html header contains the
+		// first structural html lines
+	if (mIsHeaderDone == false) {
+		listing += mListingHtmlHeader;
+		mIsHeaderDone = true;
 	}
 
-	mListingStream.close();
+	while (listing.size() < end) {
 
-}
+		const struct dirent* entry = readdir(mDir);
+
+		// all the elements were listed
+		if (entry == NULL) {
+
+			// the listing html footer contains
+				// the closing html tags
+			listing += mListingHtmlFooter;
+			close();
+			return true;
 
-void AutoIndex::generateDirListing() {
-
-	// gets all the elements within the director
-	const std::vector<std::string> dirContent 
-		= getDirContent(mDirPath);
-
-	std::vector<std::string>::const_iterator dirElement;
-	// the listing starts at the third element because
-		// the first two elements are '.' and '..' and
-		// they're not needed
-	for(dirElement = dirContent.begin() + 2; 
-		dirElement != dirContent.end(); ++dirElement) {
-		
-		mListingStream << generateDirElementRow(*dirElement);
-		if (mListingStream.fail()) {
-			throw std::runtime_error
-				("generateDirListing(): "
-				 "couldn't write to stream");
 		}
-	
+
+		// '.' and '..' aren't needed and may
+			// be anywhere in the directory stream
+		const char* name = entry->d_name;
+		if (name[0] == '.' && (name[1] == '\0'
+			|| (name[1] == '.' && name[2] == '\0')))
+			continue;
+
+		generateDirElementRow(*entry, listing);
+
 	}
 
+	return false;
+
 }
 
-std::string AutoIndex::generateDirElementRow
-	(const std::string& dirElement) {
-	
-	// gets the absolute path of the element
-		// within the directory
-	// if there is no directory slash at the end
-		// it appends it
-	const std::string dirElementFullPath
-		= mDirPath + (mDirPath[mDirPath.size() - 1] == '/' ? "" : "/")
-		+ dirElement;
+void AutoIndex::close() {
 
-	const std::string elementLinkCell = generateLinkCell(dirElementFullPath);
-	const std::string elementSizeCell = generateSizeCell(dirElementFullPath);
-	const std::string elementTimeCell = generateTimeCell(dirElementFullPath);
+	if (mDir) {
+		closedir(mDir);
+		mDir = NULL;
+	}
 
-	std::string dirElementRow 
-		= elementLinkCell + elementSizeCell + elementTimeCell;
+}
 
-	// joins all the table cells and encapsulates
-		// them in a table row
-	encapsulateTableRow(dirElementRow);
+bool AutoIndex::parsePageOptions(const std::string& query,
+	PageOptions& options) {
+
+	options.sortKey = NAME;
+	options.isDescending = false;
+	options.offset = 0;
+	options.limit = mDefaultPageLimit;
+	options.isJSON = false;
+
+	bool isPage = false;
+
+	std::string::size_type paramBegin = 0;
+	while (paramBegin <= query.size()) {
+
+		std::string::size_type paramEnd = query.find('&', paramBegin);
+		if (paramEnd == std::string::npos)
+			paramEnd = query.size();
+
+		const std::string param =
+			query.substr(paramBegin, paramEnd - paramBegin);
+
+		paramBegin = paramEnd + 1;
+
+		const std::string::size_type equalPos = param.find('=');
+		const std::string name = param.substr(0, equalPos);
+		const std::string value = equalPos == std::string::npos
+			? "" : param.substr(equalPos + 1);
+
+		const bool isNumber = value.empty() == false
+			&& value.size() <= 9 && value.find_first_not_of
+			("0123456789") == std::string::npos;
+
+		if (name == "sort" && value == "name")
+			options.sortKey = NAME;
+		else if (name == "sort" && value == "size")
+			options.sortKey = SIZE;
+		else if (name == "sort" && value == "mtime")
+			options.sortKey = MTIME;
+		else if (name == "order" && (value == "asc" || value == "desc"))
+			options.isDescending = (value == "desc");
+		else if (name == "offset" && isNumber)
+			options.offset = strToNum<size_t>(value);
+		else if (name == "limit" && isNumber)
+			options.limit = std::min(strToNum<size_t>(value),
+				mMaxPageLimit);
+		else if (name == "format" && (value == "html" || value == "json"))
+			options.isJSON = (value == "json");
+		else if (name == "sort" || name == "order" || name == "offset"
+			|| name == "limit" || name == "format") {
+
+			throw std::invalid_argument("AutoIndex::parsePageOptions(): "
+				"bad value of listing option '" + name + '\'');
 
-	return dirElementRow;
+		}
+		// other parameters aren't listing options
+		else
+			continue;
+
+		isPage = true;
+
+	}
+
+	return isPage;
 
 }
 
-std::string AutoIndex::generateSizeCell
-	(const std::string& dirElement) {
+void AutoIndex::generatePage(std::string& listing,
+	const PageOptions& options, const std::string& path) {
 
-	// stores the size of the given directory element
-	const size_t elementSize = getFileSize(dirElement);
+	if (mDir == NULL) {
+		throw std::runtime_error("AutoIndex::generatePage(): "
+			"no directory is open");
+	}
 
-	// stores directory element size if it's a file
-	// stores '-' character incase of the given 
-		// directory element is a sub directory 
-		// to indicates that the sub directory size
-		// won't be displayed
-	std::string elementSizeCell = 
-		isDir(dirElement) == false ? 
-		toString(elementSize) : "-";
-	
-	// encapsulate the element size into 
-		// a table cell
-	encapsulateTableCell(elementSizeCell);
-	
-	// returns the elemnt size cell 
-		// in the format <td>size</td>
-	return elementSizeCell;
+	const ElementOrder order(options);
 
-}
+	// the last kept element of the page is at the top
+		// so that it's the one replaced by a better one
+	std::priority_queue<Element, std::vector<Element>,
+		ElementOrder> heap(order);
 
-std::string AutoIndex::generateTimeCell
-		(const std::string& dirElement) {
-	
-	// gets the last modified time of the given
-		// directory element in tm format
-	// throws std::runtime_error on failure
-	const std::tm* lastModifiedTime 
-		= getLastModifiedTime(dirElement);
-	
-	// converts the file last modification time
-		// to the stringified format [day-mon-year hour:min]
-	std::string elementTimeCell = timeToStr(lastModifiedTime);
+	const size_t keptCount = options.offset + options.limit;
+	size_t total = 0;
+
+	// the names are sufficient to sort by name so only
+		// the kept elements are stated in that case
+	const bool isStatedOnScan = (options.sortKey != NAME);
+
+	Element element;
+
+	for (const struct dirent* entry = readdir(mDir);
+		entry != NULL; entry = readdir(mDir)) {
+
+		const char* name = entry->d_name;
+		if (name[0] == '.' && (name[1] == '\0'
+			|| (name[1] == '.' && name[2] == '\0')))
+			continue;
+
+		++total;
+
+		if (keptCount == 0)
+			continue;
+
+		// reuses the storage of the name
+		element.name.assign(name);
+		element.isStated = false;
+		element.isDir = false;
+		element.size = 0;
+		element.modTime = 0;
+
+		if (isStatedOnScan)
+			statElement(element, *entry);
+#ifdef DT_DIR
+		// the type is kept in case the
+			// element can't be stated later
+		else
+			element.isDir = (entry->d_type == DT_DIR);
+#endif
+
+		if (heap.size() < keptCount)
+			heap.push(element);
+		else if (order(element, heap.top())) {
+			heap.pop();
+			heap.push(element);
+		}
+
+	}
+
+	// the elements of the page in order
+	std::vector<Element> elements(heap.size());
+	for (size_t i = heap.size(); i > 0; --i) {
+		elements[i - 1] = heap.top();
+		heap.pop();
+	}
 
-	// encapsulate the element last modification 
-		// time into a table cell
-	encapsulateTableCell(elementTimeCell);
+	if (options.offset < elements.size())
+		elements.erase(elements.begin(), elements.begin() + options.offset);
+	else
+		elements.clear();
 
-	// returns the
-	return elementTimeCell;
+	const int dirFd = dirfd(mDir);
+
+	if (options.isJSON) {
+
+		listing = "{\"path\":";
+		appendJSONString(path, listing);
+		listing += ",\"total\":" + toString(total)
+			+ ",\"offset\":" + toString(options.offset)
+			+ ",\"limit\":" + toString(options.limit)
+			+ ",\"entries\":[";
+
+	}
+	else
+		listing = mListingHtmlHeader;
+
+	for (size_t i = 0; i < elements.size(); ++i) {
+
+		Element& pageElement = elements[i];
+
+		if (pageElement.isStated == false) {
+
+			struct stat info;
+			if (fstatat(dirFd, pageElement.name.c_str(), &info, 0) == 0) {
+				pageElement.isStated = true;
+				pageElement.isDir = S_ISDIR(info.st_mode);
+				pageElement.size = info.st_size;
+				pageElement.modTime = info.st_mtime;
+			}
+
+		}
+
+		if (options.isJSON) {
+			if (i)
+				listing += ',';
+			generateElementObject(pageElement, listing);
+		}
+		else
+			generateElementRow(pageElement, listing);
+
+	}
+
+	listing += options.isJSON ? "]}" : mListingHtmlFooter;
+
+	close();
 
 }
 
-std::string AutoIndex::generateLinkCell
-	(const std::string& dirElement) {
+AutoIndex::ElementOrder::ElementOrder(const PageOptions& options)
+	: mSortKey(options.sortKey)
+	, mIsDescending(options.isDescending) {}
 
-	// gets the URL of the element
-	const std::string& relativePath
-		= mLocation->replaceByLocRoute(dirElement);
+bool AutoIndex::ElementOrder::operator()(const Element& first,
+	const Element& second) const {
 
-	std::string dirElementHyperLinked(dirElement);
+	// elements with equal keys are ordered by name
+	int comparison = 0;
 
-	// turns the URL into a hyperlink and 
-		// encapsulates it in an anchor tag
-	encapsulateInHyperLink(dirElementHyperLinked,
-			relativePath);
+	if (mSortKey == SIZE && first.size != second.size)
+		comparison = first.size < second.size ? -1 : 1;
+	else if (mSortKey == MTIME && first.modTime != second.modTime)
+		comparison = first.modTime < second.modTime ? -1 : 1;
+	else
+		comparison = std::strcmp(first.name.c_str(),
+			second.name.c_str());
 
-	// finally turns it into a table cell
-	encapsulateTableCell(dirElementHyperLinked);
+	return mIsDescending ? comparison > 0 : comparison < 0;
 
-	return dirElementHyperLinked;
+}
+
+void AutoIndex::statElement(Element& element,
+	const struct dirent& entry) {
+
+	struct stat info;
+	element.isStated =
+		(fstatat(dirfd(mDir), entry.d_name, &info, 0) == 0);
+
+	if (element.isStated) {
+		element.isDir = S_ISDIR(info.st_mode);
+		element.size = info.st_size;
+		element.modTime = info.st_mtime;
+		return;
+	}
+
+	element.isDir = false;
+	element.size = 0;
+	element.modTime = 0;
+#ifdef DT_DIR
+	element.isDir = (entry.d_type == DT_DIR);
+#endif
 
 }
 
-void AutoIndex::encapsulateInHyperLink(std::string& content,
-	const std::string& link) {
+void AutoIndex::generateDirElementRow
+	(const struct dirent& entry, std::string& listing) {
+
+	Element element;
+	element.name = entry.d_name;
+
+	// a single stat of the element relative to the
+		// directory gives its type, size and time
+	statElement(element, entry);
 
-	const std::string openAnchorTag = std::string(
-		"<a href='" + link + "'>");
+	generateElementRow(element, listing);
+
+}
+
+void AutoIndex::generateElementRow(const Element& element,
+	std::string& listing) {
 	
-	const std::string closeAnchorTag = "</a>";
+	// gets the absolute path of the element
+		// within the directory
+	// if there is no directory slash at the end
+		// it appends it
+	std::string path = mDirPath;
+	if (path.empty() || path[path.size() - 1] != '/')
+		path += '/';
+	path += element.name;
 
-	encapsulateInTag(content, openAnchorTag, closeAnchorTag);
+	// joins all the table cells and encapsulates
+		// them in a table row
+	listing += "<tr>";
+
+	generateLinkCell(path, listing);
+
+	// an element that can't be stated (like a dangling
+		// symbolic link) is listed without its metadata
+	generateSizeCell(element.isDir || element.isStated == false,
+		element.size, listing);
+
+	if (element.isStated)
+		generateTimeCell(element.modTime, listing);
+	else
+		listing += "<td>-</td>";
+
+	listing += "</tr>";
 
 }
 
-void AutoIndex::encapsulateInTag(std::string& content,
-	const std::string& beginTag, const std::string& endTag) {
+void AutoIndex::generateElementObject(const Element& element,
+	std::string& listing) {
 
-	content.insert(0, beginTag);
+	listing += "{\"name\":";
+	appendJSONString(element.name, listing);
 
-	content.append(endTag);
+	listing += ",\"type\":";
+	listing += element.isDir ? "\"dir\"" : "\"file\"";
+
+	// an element that can't be stated has no metadata
+	if (element.isStated) {
+		listing += ",\"size\":" + toString(element.size);
+		listing += ",\"mtime\":" + toString(element.modTime);
+	}
+
+	listing += '}';
 
 }
 
-void AutoIndex::encapsulateTableRow(std::string& content) {
-	
-	const std::string openTRtag = "<tr>";
+void AutoIndex::appendJSONString(const std::string& str,
+	std::string& listing) {
+
+	static const char hexDigits[] = "0123456789abcdef";
+
+	listing += '"';
+
+	for (std::string::size_type i = 0; i < str.size(); ++i) {
+
+		const unsigned char c = str[i];
+
+		if (c == '"' || c == '\\') {
+			listing += '\\';
+			listing += c;
+		}
+		// control characters are escaped as \u00XX
+		else if (c < 0x20) {
+			listing += "\\u00";
+			listing += hexDigits[c >> 4];
+			listing += hexDigits[c & 0xF];
+		}
+		else
+			listing += c;
 
-	const std::string closeTRtag = "</tr>";
+	}
 
-	encapsulateInTag(content, openTRtag, closeTRtag);
+	listing += '"';
 
 }
 
-void AutoIndex::encapsulateTableCell
-	(std::string& content) {
+void AutoIndex::generateLinkCell(const std::string& path,
+	std::string& listing) {
+
+	// turns the URL of the element into a hyperlink
+		// in an anchor tag within a table cell
+	listing += "<td><a href='";
+	listing += mLocation->replaceByLocRoute(path);
+	listing += "'>";
+	listing += path;
+	listing += "</a></td>";
 
-	const std::string openTdTag = "<td>";
+}
+
+void AutoIndex::generateSizeCell(const bool isDirectory,
+	const off_t size, std::string& listing) {
 
-	const std::string closeTdTag = "</td>";
+	// '-' is used incase of the given 
+		// directory element is a sub directory 
+		// to indicates that the sub directory size
+		// won't be displayed
+	listing += "<td>";
+	listing += isDirectory ? "-" : toString(size);
+	listing += "</td>";
+
+}
+
+void AutoIndex::generateTimeCell(const std::time_t modTime,
+	std::string& listing) {
+
+	// converts the file last modification time
+		// to the stringified format [day-mon-year hour:min]
+	const std::tm* lastModifiedTime = std::localtime(&modTime);
 
-	encapsulateInTag(content, openTdTag, closeTdTag);
+	listing += "<td>";
+	if (lastModifiedTime)
+		listing += timeToStr(lastModifiedTime);
+	listing += "</td>";
 
 }
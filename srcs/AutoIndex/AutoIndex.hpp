@@ -2,19 +2,33 @@
  * This class generates an html listing of a directory that's
  * passed to it. The listing is in the following format:
  *  [File Size Last-Modified], and the generated html listing
- *  will be saved in the file path that is passed to it
+ *  is rendered in memory
  * A hyperlink will be embedded in the File name containing
  *  A URL to the file. The URL will be relative to the location
  *  parameter that's passed to this class
+ * The directory is read as the listing is generated, so a large
+ *  listing can be produced in parts of a bounded size while it's
+ *  being sent. The metadata of each element is taken with a single
+ *  fstatat() relative to the open directory
+ * A page of the listing can also be requested with query parameters:
+ *  sort=name|size|mtime, order=asc|desc, offset=N, limit=N and
+ *  format=html|json. Only the elements of the page are kept while
+ *  the directory is scanned (top-k selection with a heap), so the
+ *  cost of a page is bounded by offset + limit and not by the size
+ *  of the directory
  */
 
 #pragma once
 
-#include <fstream>
 #include <utils.hpp>
-#include <vector>
 #include <Config.hpp>
 #include <stdexcept>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <vector>
+#include <queue>
+#include <cstring>
 
 class AutoIndex {
 
@@ -22,24 +36,89 @@ class AutoIndex {
 		/******* alias types *******/
 		typedef Config::ConstLocPtr ConstLocPtr;
 
+		/******* nested types *******/
+		// key by which the elements of a page are sorted
+		enum SortKey {
+			NAME,
+			SIZE,
+			MTIME
+		};
+
+		// options of a page of the listing
+		struct PageOptions {
+			SortKey sortKey;
+			bool isDescending;
+			size_t offset;
+			size_t limit;
+			bool isJSON;
+		};
+
 		/******* public member functions *******/
-		AutoIndex(const std::string& dirPath, 
-			const std::string& listingFileOutputPath,
+		AutoIndex();
+
+		// parses the listing options of the query string
+		// returns true and fills options if at least one of
+			// them was given (defaults are used for the others)
+		// returns false if none was given
+		// throws std::invalid_argument if one has a bad value
+		static bool parsePageOptions(const std::string& query,
+			PageOptions& options);
+
+		// closes the directory if it's still open
+		~AutoIndex();
+
+		// opens the directory at dirPath whose elements' links
+			// are relative to location so that its listing
+			// can be generated
+		// throws std::runtime_error if it can't be opened
+		void open(const std::string& dirPath,
 			ConstLocPtr location);
-		
-		// generates the listing html file
-			// by extracting the input directory
-			// elements and saves the generated 
-			// html in the outputFile
+
+		// appends the next part of the listing html to listing
+			// until it grows by at least size bytes or
+			// the listing ends
+		// returns true when the whole listing was generated
+			// (the directory is closed then)
+		// throws std::runtime_error on failure
+		bool generate(std::string& listing, const size_t size);
+
+		// generates the page of the listing described by
+			// options and stores it in listing
+		// path is the requested path that's reported
+			// in the json format
+		// the directory is closed afterwards
 		// throws std::runtime_error on failure
-		void generate();
+		void generatePage(std::string& listing,
+			const PageOptions& options, const std::string& path);
 
 	private:
-		/******* private member objects *******/
-		// the file path where the generated html
-			// listing will be saved
-		std::string mListingFilePath;
+		/******* private nested types *******/
+		// an element of the directory kept for a page
+		struct Element {
+			std::string name;
+			bool isStated;
+			bool isDir;
+			off_t size;
+			std::time_t modTime;
+		};
+
+		// returns true if an element comes before
+			// another one in a page
+		class ElementOrder {
+
+			public:
+				ElementOrder(const PageOptions& options);
+
+				bool operator()(const Element& first,
+					const Element& second) const;
 
+			private:
+				SortKey mSortKey;
+				bool mIsDescending;
+
+		};
+
+		/******* private member objects *******/
 		// the input directory that will be listed
 		std::string mDirPath;
 
@@ -47,9 +126,12 @@ class AutoIndex {
 			// configuration of the requested path
 		ConstLocPtr mLocation;
 
-		// stream where the output of the autoindex
-			// listing will be generated
-		std::ofstream mListingStream;
+		// stream of the directory elements
+			// (NULL if it's not open)
+		DIR* mDir;
+
+		// set when the html header was generated
+		bool mIsHeaderDone;
 
 		// contains the first lines of the listing 
 			// html file , this part of the html file
@@ -65,68 +147,62 @@ class AutoIndex {
 			// tags of the listing html file
 		static const std::string mListingHtmlFooter;
 
+		// number of elements of a page if no limit
+			// was given, and maximum limit
+		static const size_t mDefaultPageLimit;
+		static const size_t mMaxPageLimit;
+
 		/******* private member functions *******/
+		// copying would share the directory stream
+		AutoIndex(const AutoIndex&);
 
-		/* all generate*() functions call external functions
-		 *  that may throw std::exception
-		 */
-		
-		// extracts the input directory content
-			// writes an html section of table rows for each element
-			// to the listing to the listing stream member
-		void generateDirListing();
+		AutoIndex& operator=(const AutoIndex&);
 
-		// takes the input directory element
-		// returns the element info in the format
-			// [File Size Last-Modified] encapsulated 
-			// in a <tr> html tag
-		std::string generateDirElementRow
-			(const std::string& dirElement);
-		
-		// takes the input directory element
-		// returns the link that will be used
-			// to request the given element
-			// encapsulated in a <td> html tag
-		std::string generateLinkCell
-			(const std::string& dirElement);
+		// closes mDir
+		void close();
 
-		// takes the input directory element
-		// returns the given element size
-			// if it's a file otherwise
-			// a '-' character is returned
-		// the element size will be encapsulated 
-			// in a <td> html tag
-		std::string generateSizeCell
-			(const std::string& dirElement);
+		// fills the metadata of element from the
+			// directory entry (d_type is used if it
+			// can't be stated)
+		void statElement(Element& element,
+			const struct dirent& entry);
+
+		// appends the row of element to listing
+		void generateElementRow(const Element& element,
+			std::string& listing);
+
+		// appends the json object of element to listing
+		void generateElementObject(const Element& element,
+			std::string& listing);
+
+		// appends str to listing as a json string
+		static void appendJSONString(const std::string& str,
+			std::string& listing);
 
 		// takes the input directory element
-		// returns the last modification time
-			// of the given element encapsulated in 
-			// a <td> html tag
-		std::string generateTimeCell
-			(const std::string& dirElement);
-
-		/* all encapsulte*() functions call encapsulateInTag()
-		 *  for their encapsulation needs
-		 */
-		// takes content and inserts beginTag at its beginning
-			// and endTage at its end
-		// example : content = name, btag = <td>, etag = </td>
-		//  content becomes <td>content</td>
-		void encapsulateInTag(std::string& content,
-			const std::string& beginTag, const std::string& endTag);
-
-		// takes a link and puts it in an anchor tag like this:
-			// <a href='link'> and encapsulates the content
-			// between that tag and this one </a>
-		void encapsulateInHyperLink(std::string& content,
-			const std::string& link);
-
-		// encapsultes content between <td> and </td>
-		void encapsulateTableCell(std::string& content);
-
-		// encapsultes content between <tr> and </tr>
-		void encapsulateTableRow(std::string& content);
+		// appends the element info in the format
+			// [File Size Last-Modified] encapsulated 
+			// in a <tr> html tag to listing
+		// the element's type from the directory entry
+			// is used if it can't be stated
+		void generateDirElementRow(const struct dirent& entry,
+			std::string& listing);
+
+		// appends the link that will be used to request
+			// the element at path encapsulated
+			// in a <td> html tag to listing
+		void generateLinkCell(const std::string& path,
+			std::string& listing);
+
+		// appends the given element size if it's a file
+			// otherwise a '-' character encapsulated
+			// in a <td> html tag to listing
+		void generateSizeCell(const bool isDirectory,
+			const off_t size, std::string& listing);
+
+		// appends the last modification time of the given
+			// element encapsulated in a <td> html tag to listing
+		void generateTimeCell(const std::time_t modTime,
+			std::string& listing);
 		
 };
-
@@ -0,0 +1,98 @@
+/* this file contains the implementation of the ListingCache class */
+
+#include <ListingCache.hpp>
+
+ListingCache::Entries ListingCache::mEntries;
+
+size_t ListingCache::mTotalSize = 0;
+
+unsigned long ListingCache::mUseCounter = 0;
+
+const size_t ListingCache::mMaxTotalSize = 8 * 1024 * 1024;
+
+const size_t ListingCache::mMaxEntrySize = 1024 * 1024;
+
+bool ListingCache::find(const std::string& path,
+	ConstLocPtr location, const std::time_t modTime,
+	const size_t size, SharedBuffer& listing) {
+
+	const Entries::iterator entry =
+		mEntries.find(Key(path, location));
+
+	if (entry == mEntries.end())
+		return false;
+
+	// the directory changed since it was listed
+		// so the entry can't be used anymore
+	if (entry->second.modTime != modTime
+		|| entry->second.size != size) {
+		erase(entry);
+		return false;
+	}
+
+	entry->second.lastUse = ++mUseCounter;
+	listing = entry->second.listing;
+
+	return true;
+
+}
+
+void ListingCache::store(const std::string& path,
+	ConstLocPtr location, const std::time_t modTime,
+	const size_t size, const SharedBuffer& listing) {
+
+	if (listing.getSize() > mMaxEntrySize)
+		return;
+
+	const Key key(path, location);
+
+	// replaces any older listing of the directory
+	const Entries::iterator oldEntry = mEntries.find(key);
+	if (oldEntry != mEntries.end())
+		erase(oldEntry);
+
+	evict(listing.getSize());
+
+	Entry& entry = mEntries[key];
+	entry.modTime = modTime;
+	entry.size = size;
+	entry.listing = listing;
+	entry.lastUse = ++mUseCounter;
+
+	mTotalSize += listing.getSize();
+
+}
+
+size_t ListingCache::getMaxEntrySize() {
+	return mMaxEntrySize;
+}
+
+void ListingCache::erase(Entries::iterator entry) {
+
+	// the listing stays alive for the
+		// responses that are still sending it
+	mTotalSize -= entry->second.listing.getSize();
+	mEntries.erase(entry);
+
+}
+
+void ListingCache::evict(const size_t size) {
+
+	while (mEntries.empty() == false
+		&& mTotalSize + size > mMaxTotalSize) {
+
+		Entries::iterator leastRecent = mEntries.begin();
+
+		for (Entries::iterator entry = mEntries.begin();
+			entry != mEntries.end(); ++entry) {
+
+			if (entry->second.lastUse < leastRecent->second.lastUse)
+				leastRecent = entry;
+
+		}
+
+		erase(leastRecent);
+
+	}
+
+}
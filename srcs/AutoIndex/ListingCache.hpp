@@ -0,0 +1,85 @@
+/* this file contains the definition of the ListingCache class
+ * It keeps in memory the html listings generated by AutoIndex so
+ *  that a directory that's browsed repeatedly is only read again
+ *  when it changes
+ * An entry is keyed by the path of the directory (followed by the
+ *  query string for a page of the listing) and the location whose
+ *  route its links are relative to, and is only valid for the
+ *  modification time and size the directory had when it was listed
+ * The total size of the entries is bounded and the least recently
+ *  used ones are evicted to make room for new ones
+ */
+
+#pragma once
+
+#include <string>
+#include <map>
+#include <utility>
+#include <ctime>
+#include <Config.hpp>
+#include <SharedBuffer.hpp>
+
+class ListingCache {
+
+	public:
+		/******* alias types *******/
+		typedef Config::ConstLocPtr ConstLocPtr;
+
+		/******* public member functions *******/
+		// looks for the listing of path (under location) that
+			// was generated for the given modification time and
+			// size of the directory
+		// returns true and sets listing to it if one is found
+		static bool find(const std::string& path,
+			ConstLocPtr location, const std::time_t modTime,
+			const size_t size, SharedBuffer& listing);
+
+		// stores the listing of path (under location)
+		// it has no effect if listing is larger than
+			// the maximum entry size
+		static void store(const std::string& path,
+			ConstLocPtr location, const std::time_t modTime,
+			const size_t size, const SharedBuffer& listing);
+
+		// returns the maximum size of a single entry
+		static size_t getMaxEntrySize();
+
+	private:
+		/******* private nested types *******/
+		struct Entry {
+			std::time_t modTime;
+			size_t size;
+			SharedBuffer listing;
+			// value of mUseCounter when the
+				// entry was last used
+			unsigned long lastUse;
+		};
+
+		/******* alias types *******/
+		typedef std::pair<std::string, ConstLocPtr> Key;
+		typedef std::map<Key, Entry> Entries;
+
+		/******* private member objects *******/
+		static Entries mEntries;
+
+		// sum of the sizes of all the stored listings
+		static size_t mTotalSize;
+
+		// incremented on every use of an entry
+		static unsigned long mUseCounter;
+
+		// maximum sum of the sizes of all the entries
+		static const size_t mMaxTotalSize;
+
+		// maximum size of a single entry
+		static const size_t mMaxEntrySize;
+
+		/******* private member functions *******/
+		// removes entry from the cache
+		static void erase(Entries::iterator entry);
+
+		// evicts the least recently used entries until
+			// size more bytes can be stored
+		static void evict(const size_t size);
+
+};
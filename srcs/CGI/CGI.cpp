@@ -7,11 +7,26 @@ const int CGI::mWaitTime = 1;
 
 const size_t CGI::mMaxHeadersSize = 400;
 
+const size_t CGI::mDefaultPipeSize = 65536;
+
+const size_t CGI::mOutputReadSize = 65536;
+
 CGI::CGI(const Request& request)
-	: mStatusCode(StatusCodeHandler::OK)
+	: mInput()
+	, mInputBuffer()
+	, mInputFd(-1)
+	, mIsInputPipe()
+	, mOutput()
+	, mStatusCode(StatusCodeHandler::OK)
 	, mContentLength()
+	, mBodyOffset()
 	, mRequest(request)
-	, mScriptPath(mRequest.getFullPath()) {}
+	, mScriptPath(mRequest.getFullPath()) {
+
+	mOutputPipe[0] = -1;
+	mOutputPipe[1] = -1;
+
+}
 
 void CGI::run() {
 
@@ -24,18 +39,21 @@ void CGI::run() {
 
 }
 
-void CGI::setInputFilePath
-	(const std::string& path) {
-	
-	mInputFilePath = path;
+CGI::~CGI() {
+	closeInputPipe();
+	closeOutputPipe();
+}
 
+void CGI::setInput(const TempFile& input) {
+	mInput = &input;
 }
 
-void CGI::setOutputFilePath
-	(const std::string& path) {
-	
-	mOutputFilePath = path;
+void CGI::setInput(const std::string& input) {
+	mInputBuffer = &input;
+}
 
+void CGI::setOutput(TempFile& output) {
+	mOutput = &output;
 }
 
 bool CGI::isValid() {
@@ -56,8 +74,31 @@ size_t CGI::getContentLength() {
 	return mContentLength;
 }
 
+const std::string& CGI::getHeaders() const {
+	return mHeaders;
+}
+
+size_t CGI::getBodyOffset() const {
+	return mBodyOffset;
+}
+
 void CGI::manageExecution() {
 
+	// the input is prepared by the server since a pipe
+		// has to be filled before the script reads it
+	try {
+
+		if (mRequest.getMethod() == Request::POST)
+			setInputFd();
+
+		openOutputPipe();
+
+	}
+	catch (const std::exception& e) {
+		mStatusCode = StatusCodeHandler::SERVER_ERROR;
+		return ;
+	}
+
 	// creates a new process for the
 		// cgi to be run
 	const pid_t pid = fork();
@@ -91,8 +132,17 @@ void CGI::manageExecution() {
 		}
 
 	}
+
+	// the script has its own copy of the pipes
+		// (the output pipe reaches its end once
+		// the script closes its copy)
+	closeInputPipe();
+	close(mOutputPipe[1]);
+	mOutputPipe[1] = -1;
+
 	// couldn't create the new process
-	else if (pid == -1) {
+	if (pid == -1) {
+		closeOutputPipe();
 		mStatusCode = StatusCodeHandler::SERVER_ERROR;
 		return ;
 	}
@@ -104,24 +154,70 @@ void CGI::manageExecution() {
 
 void CGI::waitForScript(const pid_t pid) {
 
-	// stops the execution for mWaitTime time
-		// so that the script can finish its job
-		// before its output is read
-	sleep(mWaitTime);
-	
-	// gets the script's termination status
-	pid_t status = waitpid(pid, NULL, WNOHANG);
+	const long deadline = getMilliseconds() + mWaitTime * 1000;
+
+	// set once the script closed its output
+	bool isOutputDone = false;
+
+	// set if the output couldn't be collected
+	bool isFailed = false;
+
+	// the termination status of the script
+		// (0 while it's still running)
+	pid_t status = 0;
+
+	// reads the output until the script closes it and
+		// terminates or until mWaitTime passed
+	while (status == 0 && isFailed == false) {
+
+		if (isOutputDone)
+			status = waitpid(pid, NULL, WNOHANG);
+
+		const long timeLeft = deadline - getMilliseconds();
+		if (status != 0 || timeLeft <= 0)
+			break;
+
+		// waits for the output or checks the
+			// termination again a bit later
+		struct pollfd output = pollfd();
+		output.fd = mOutputPipe[0];
+		output.events = POLLIN;
+
+		const int readyCount = isOutputDone
+			? poll(NULL, 0, 1) : poll(&output, 1, timeLeft);
+
+		if (readyCount == -1 && errno != EINTR)
+			isFailed = true;
+		else if (readyCount > 0) {
+
+			try {
+				isOutputDone = (readOutput() == false);
+			}
+			catch (const std::exception& e) {
+				isFailed = true;
+			}
+
+		}
+
+	}
+
+	closeOutputPipe();
+
+	// kills the script if it didn't terminate
+		// on time or if its output was lost
+	if (status == 0) {
+		kill(pid, SIGKILL);
+		waitpid(pid, NULL, 0);
+	}
 
 	// checks if there was an error when getting
 		// the termination status
-	if (status < 1) {
+	if (status < 1 || isFailed) {
 
 		mStatusCode = StatusCodeHandler::SERVER_ERROR;
-		// kills the script if it didn't terminate
-			// on time
-		if (status == 0) {
 
-			kill(pid, SIGKILL);
+		if (status == 0 && isFailed == false) {
+
 			const std::string errorMsg = std::string(
 				"CGI::waitForScript(): ") + mScriptPath
 				+ " timed out";
@@ -134,6 +230,57 @@ void CGI::waitForScript(const pid_t pid) {
 
 }
 
+bool CGI::readOutput() {
+
+	char buffer[mOutputReadSize];
+
+	ssize_t readBytes = read(mOutputPipe[0], buffer, sizeof(buffer));
+	while (readBytes == -1 && errno == EINTR)
+		readBytes = read(mOutputPipe[0], buffer, sizeof(buffer));
+
+	// the script closed its output (or it can't be read anymore)
+	if (readBytes <= 0)
+		return false;
+
+	// a memory storage moves to the disk if it grows too large
+	mOutput->write(buffer, readBytes);
+
+	return true;
+
+}
+
+void CGI::openOutputPipe() {
+
+	if (mOutput == NULL || pipe(mOutputPipe) == -1) {
+		throw std::runtime_error("CGI::openOutputPipe(): "
+			"couldn't create the output pipe");
+	}
+
+	// only the duplicate made by the script is kept open
+	fcntl(mOutputPipe[0], F_SETFD, FD_CLOEXEC);
+	fcntl(mOutputPipe[1], F_SETFD, FD_CLOEXEC);
+
+}
+
+void CGI::closeOutputPipe() {
+
+	for (int i = 0; i < 2; ++i) {
+		if (mOutputPipe[i] != -1)
+			close(mOutputPipe[i]);
+		mOutputPipe[i] = -1;
+	}
+
+}
+
+long CGI::getMilliseconds() {
+
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (now.tv_sec * 1000 + now.tv_nsec / 1000000);
+
+}
+
 void CGI::setScriptIO() {
 
 	// boilerplate exception message
@@ -144,41 +291,115 @@ void CGI::setScriptIO() {
 	
 	if (mRequest.getMethod() == Request::POST) {
 
-		const int input = open(mInputFilePath.c_str(),  O_RDONLY);
-		if (input == -1) {
-			throw std::runtime_error(errorMsg
-			+ "open " + mInputFilePath + " for input");
-		}
-
 		// made the standard input stream of the executed
-			// script point to the input file instead so
-			// it can automatically read from it
-		if (dup2(input, STDIN_FILENO) == -1) {
+			// script point to the input file (or pipe)
+			// instead so it can automatically read from it
+		if (dup2(mInputFd, STDIN_FILENO) == -1) {
 			throw std::runtime_error(errorMsg
 				+ "duplicate the input");
 		}
 	
 	}
 
-	// opens in write mode and clears any existing
-		// data if the file exists already
-	const int output = open(mOutputFilePath.c_str(),
-		O_WRONLY | O_TRUNC | O_CREAT, 0666);
-	if (output == -1) {
-		throw std::runtime_error(errorMsg
-		+ "open " + mOutputFilePath + " for output");
-	}
-
 	// made the standard output stream of the executed
-		// script point to the output file instead so
+		// script point to the output pipe instead so
 		// it can automatically write to it
-	if (dup2(output, STDOUT_FILENO) == -1) {
+	if (dup2(mOutputPipe[1], STDOUT_FILENO) == -1) {
 		throw std::runtime_error(errorMsg
 			+ "duplicate the output");
 	}
 	
 }
 
+void CGI::setInputFd() {
+
+	if (mInputBuffer) {
+
+		if (fillInputPipe())
+			return ;
+
+		// the input is too large for a pipe
+		mInputFile.create(TempFile::MEMORY);
+		mInputFile.write(mInputBuffer->data(), mInputBuffer->size());
+		mInputFd = mInputFile.getFd();
+
+	}
+	else if (mInput)
+		mInputFd = mInput->getFd();
+
+	// the body was written up to the end of the input
+		// so the script has to read it from its start
+	if (mInputFd == -1 || lseek(mInputFd, 0, SEEK_SET) == -1) {
+		throw std::runtime_error("CGI::setInputFd(): "
+			"couldn't rewind the input");
+	}
+
+}
+
+bool CGI::fillInputPipe() {
+
+	int pipeFds[2];
+
+	if (pipe(pipeFds) == -1)
+		return false;
+
+	// only the duplicate made by the script is kept open
+	fcntl(pipeFds[0], F_SETFD, FD_CLOEXEC);
+	fcntl(pipeFds[1], F_SETFD, FD_CLOEXEC);
+
+	// nothing reads the pipe before the script is started
+		// so a full pipe must not block the server
+	fcntl(pipeFds[1], F_SETFL, O_NONBLOCK);
+
+	const size_t inputSize = mInputBuffer->size();
+
+#ifdef F_SETPIPE_SZ
+	// may fail if the size is above the system's limit in
+		// which case the write below stops when it's full
+	if (inputSize > mDefaultPipeSize)
+		fcntl(pipeFds[1], F_SETPIPE_SZ, inputSize);
+#endif
+
+	size_t written = 0;
+	while (written < inputSize) {
+
+		const ssize_t writtenBytes = write(pipeFds[1],
+			mInputBuffer->data() + written, inputSize - written);
+
+		if (writtenBytes == -1 && errno == EINTR)
+			continue;
+
+		if (writtenBytes <= 0)
+			break;
+
+		written += writtenBytes;
+
+	}
+
+	// the script gets an end of file after the input
+	close(pipeFds[1]);
+
+	if (written < inputSize) {
+		close(pipeFds[0]);
+		return false;
+	}
+
+	mInputFd = pipeFds[0];
+	mIsInputPipe = true;
+
+	return true;
+
+}
+
+void CGI::closeInputPipe() {
+
+	if (mIsInputPipe)
+		close(mInputFd);
+
+	mIsInputPipe = false;
+
+}
+
 void CGI::setEnv() {
 
 	// boilerplate exception message
@@ -237,8 +458,9 @@ void CGI::setEnv() {
 
 			header = mRequest.getHeaderValue("transfer-encoding");
 			if (header && *header == "chunked") {
-				const size_t chunkedBodySize
-					= getFileSize(mRequest.getPathToBodyFileName());
+				const size_t chunkedBodySize = mInputBuffer
+					? mInputBuffer->size()
+					: mInput ? mInput->getSize() : 0;
 				setenv("CONTENT_LENGTH", 
 					toString(chunkedBodySize).c_str(), overwite);
 			}
@@ -281,14 +503,11 @@ void CGI::setContentLength() {
 	// since the headers are too large
 	std::string headers(mMaxHeadersSize, '\0');
 
-	// opens the file stream containing script's output
-	std::ifstream outputStream(mOutputFilePath.c_str(),
-		std::ofstream::in | std::ofstream::binary);
-
-	outputStream.read(&headers[0], mMaxHeadersSize);
-	// if reading fails before reaching EOF
-	if (outputStream.eof() == false
-		&& outputStream.fail()) {
+	// reads the start of the script's output
+		// from the output file's descriptor
+	const ssize_t readBytes = pread(mOutput->getFd(),
+		&headers[0], mMaxHeadersSize, 0);
+	if (readBytes == -1) {
 		
 		mStatusCode = StatusCodeHandler::SERVER_ERROR;
 		throw std::runtime_error(errorMsg);
@@ -297,7 +516,7 @@ void CGI::setContentLength() {
 
 	// sets the headers to the actual size
 		// that was read
-	headers.resize(outputStream.gcount());
+	headers.resize(readBytes);
 
 	const std::string::size_type bodySeparatorPos
 		= headers.find("\r\n\r\n");
@@ -310,13 +529,16 @@ void CGI::setContentLength() {
 
 	}
 	
-	const size_t outpuFileSize =
-		getFileSize(mOutputFilePath);
-	
+	const size_t outpuFileSize = mOutput->getSize();
+
+	// keeps the CRLF of the last header field
+	mHeaders = headers.substr(0, bodySeparatorPos + 2);
+
+	mBodyOffset = bodySeparatorPos + 4;
+
 	// the size of the entity body without
 		// the headers and the body separator
-	mContentLength = outpuFileSize - 
-		(bodySeparatorPos + 4);
+	mContentLength = outpuFileSize - mBodyOffset;
 
 }
 
@@ -1,8 +1,15 @@
 /* this file contains the definition of the CGI class.
  * It gets an input in case of post, runs a CGI script
  *  with a specified executable and writes the output to a file.
- * The input and output files should be set before
- *  the CGI is run.
+ * The input and output files are anonymous temporary files
+ *  (TempFile) that should be set before the CGI is run.
+ * An input that's in memory is written to a pipe from which the
+ *  script reads it, so that it never goes through a file unless
+ *  it doesn't fit in the pipe.
+ * The script writes its output to a pipe that's read while it runs
+ *  and the output is collected in the output TempFile, so a memory
+ *  storage is moved to the disk only if the output grows past its
+ *  limit.
  * All the other necessary information will be retrieved
  *  from the request object that's passed to its constructor
  */
@@ -16,6 +23,10 @@
 #include <signal.h>
 #include <fcntl.h>
 #include <stdlib.h>
+#include <poll.h>
+#include <ctime>
+#include <cerrno>
+#include <TempFile.hpp>
 
 class CGI {
 
@@ -30,9 +41,21 @@ class CGI {
 		/******* public member functions *******/
 		CGI(const Request& request);
 
-		void setInputFilePath(const std::string& path);
+		// sets the file from which the script reads
+			// the request body (POST only)
+		void setInput(const TempFile& input);
 
-		void setOutputFilePath(const std::string& path);
+		// same as above but the request body
+			// is in memory
+		void setInput(const std::string& input);
+
+		// closes the read end of the input pipe
+			// and the output pipe
+		~CGI();
+
+		// sets the storage where the output of
+			// the script is collected
+		void setOutput(TempFile& output);
 
 		void run();
 
@@ -44,23 +67,58 @@ class CGI {
 		// gets the content length of the body
 			// that is generated by the script 
 		size_t getContentLength();
+
+		// gets the header section generated by the script
+			// (each field ends with a CRLF but the empty
+			// line that ends the section isn't included)
+		const std::string& getHeaders() const;
+
+		// gets the offset of the body within
+			// the script's output file
+		size_t getBodyOffset() const;
 	
 	private:
 		/******* private member objects *******/
-		// the file path from which the CGI
-			// gets its input (request body)
-		// if the method is not GET, then there
+		// the file from which the CGI gets
+			// its input (request body)
+		// if the method is not POST, then there
 			// is no input
-		std::string mInputFilePath;
+		const TempFile* mInput;
+
+		// used instead of mInput if it's set
+		const std::string* mInputBuffer;
+
+		// descriptor that becomes the standard input
+			// of the script (-1 if there is no input)
+		int mInputFd;
 
-		// the filepath where the cgi script
-			// will save its output
-		std::string mOutputFilePath;
+		// set if mInputFd is the read end of a pipe
+			// that the server has to close
+		bool mIsInputPipe;
+
+		// where mInputBuffer is written if it doesn't
+			// fit in a pipe
+		TempFile mInputFile;
+
+		// the storage where the output
+			// of the cgi script is collected
+		TempFile* mOutput;
+
+		// pipe to which the script writes its output
+			// (-1 when an end is closed)
+		int mOutputPipe[2];
 
 		StatusCodeType mStatusCode;
 
 		size_t mContentLength;
 
+		// header section of the script's output
+		std::string mHeaders;
+
+		// position of the first body byte
+			// in the script's output file
+		size_t mBodyOffset;
+
 		const Request& mRequest;
 
 		// the full path of the cgi script
@@ -78,6 +136,14 @@ class CGI {
 			// , then it's an invalid output
 		static const size_t mMaxHeadersSize;
 
+		// pipes are created with this capacity on linux
+			// and are grown to hold larger inputs
+		static const size_t mDefaultPipeSize;
+
+		// amount of bytes read from the output
+			// pipe on each attempt
+		static const size_t mOutputReadSize;
+
 		/******* private member functions *******/
 		// runs the executable as a child process, calls
 			// the functions that prepare the script's environment
@@ -97,12 +163,44 @@ class CGI {
 			// amount of time. if it takes more, then the script
 			// times out and status code is set accordingly and also
 			// throws std::runtime_error
+		// the output is collected in mOutput while it runs
+			// so it returns as soon as the script is done
 		// takes the process id of the executed script
 		void waitForScript(const pid_t pid);
 
-		// sets the script to read its input from mInputFilePath
+		// reads the available bytes of the output pipe
+			// and appends them to mOutput
+		// returns false once the script closed its output
+		// throws std::runtime_error if mOutput can't be written
+		bool readOutput();
+
+		// creates mOutputPipe
+		// throws std::runtime_error in case of error
+		void openOutputPipe();
+
+		// closes the ends of mOutputPipe that are still open
+		void closeOutputPipe();
+
+		// returns the time of a monotonic clock in milliseconds
+		static long getMilliseconds();
+
+		// sets mInputFd from mInputBuffer or mInput
+			// before the script is started
+		// throws std::runtime_error in case of error
+		void setInputFd();
+
+		// writes mInputBuffer to a new pipe and sets mInputFd
+			// to its read end
+		// returns false if the input didn't fit in the pipe
+		bool fillInputPipe();
+
+		// closes the read end of the input pipe once the
+			// script has its own copy of it
+		void closeInputPipe();
+
+		// sets the script to read its input from mInputFd
 			// in case of POST request Method
-			// and to write its output to mOutputFilePath
+			// and to write its output to mOutputPipe
 		// if IO couldn't be set, status code is set accordinly
 		// throws std::runtime_error in case of error
 		void setScriptIO();
@@ -123,6 +221,8 @@ class CGI {
 		// sets the content length of the body
 			// that is generated by the script
 			// (without the headers)
+		// also sets the header section of the output
+			// and the offset of the body
 		// throws std::runtime_error in case
 			// the content length couldn't be determined
 		void setContentLength();
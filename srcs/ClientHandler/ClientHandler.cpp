@@ -22,6 +22,11 @@ ClientHandler::ClientHandler(const ClientHandler& handler)
 
 bool ClientHandler::isRead() {
 
+	// the response may wait for the kernel
+		// to be done with its body
+	if (mStage == RESPONSE)
+		return mResponse.isRead();
+
 	// doesn't need reading when
 		// the request stage is over
 	if (mStage != REQUEST)
@@ -33,6 +38,10 @@ bool ClientHandler::isRead() {
 		return false;
 	}
 
+	// the request writes before reading the body
+	if (mRequest.isWrite())
+		return false;
+
 	if (mRequest.isRead() == false) {
 
 		// if request is done, moves to the
@@ -50,6 +59,10 @@ bool ClientHandler::isRead() {
 
 bool ClientHandler::isWrite() {
 
+	// the request may write an interim response
+	if (mStage == REQUEST)
+		return mRequest.isWrite();
+
 	// doesn't need writing if not in
 		// the respone stage
 	if (mStage != RESPONSE)
@@ -57,7 +70,8 @@ bool ClientHandler::isWrite() {
 
 	// if respone is done, moves to the
 		// closing stage
-	if (mResponse.isWrite() == false) {
+	if (mResponse.isWrite() == false
+		&& mResponse.isRead() == false) {
 		closeClientConnection();
 		return false;
 	}
@@ -1,9 +1,11 @@
-/* this file contains the implementaion of the Config class and its nested class LocationContext */
+/* this file contains the implementaion of the Config class and its nested classes */
 
 #include <Config.hpp>
 
 const std::string Config::ServerContext::defaultHostname = "0.0.0.0";
 const std::string Config::ServerContext::defaultPort = "8080";
+const Config::Size
+	Config::ServerContext::defaultClientBodyBufferSize = 16384;
 
 const std::string Config::defaultConfigFileName
 	= "./config_files/default_config";
@@ -34,28 +36,27 @@ Config::Config(const char *fileName) {
 Config::Servers& Config::getServers() { return mServers; }
 
 Config::LocationContext::LocationContext()
-	: get(), post(), del(), autoindex() {}
+	: get(), post(), del(), put(), autoindex(), gzipStatic()
+	, gzip(), gzipCompLevel(6), gzipMinLength(20), expires(-1)
+	, uploadSync(SYNC_OFF), uploadSyncInterval(), uploadDirect()
+	, zerocopy(), zerocopyMinSize(65536) {}
 
 Config::ServerContext::ServerContext()
 	: socketID(-1)
-	, clientBodySizeMax() {}
+	, clientBodySizeMax()
+	, clientBodyBufferSize(defaultClientBodyBufferSize) {}
 
 Config::ConstLocPtr
 	Config::ServerContext::getLocation
 	(const std::string& path) const {
 
-	for (LocationsCollection::const_iterator loc =
-		locations.begin(); loc != locations.end();
-		++loc) {
-		
-		// if path found, returns address
-			// of locaction context
-		if (loc->first == path)
-			return &loc->second;
+	const LocationsCollection::const_iterator
+		location = locations.find(path);
 
-	}
+	if (location == locations.end())
+		return NULL;
 
-	return NULL;
+	return &location->second;
 
 }
 
@@ -69,8 +70,10 @@ std::string Config::LocationContext::replaceByRoot
 
 	// takes the end position of the location
 		// prefix in the path
+	// a location ending with '/' also matches the
+		// path without it, which is shorter than it
 	const std::string::size_type
-		endOfLocPrefixPos = route.size();
+		endOfLocPrefixPos = std::min(route.size(), path.size());
 
 	// removes the location prefix and prepends
 		// the replacement to it
@@ -105,41 +108,146 @@ std::string Config::LocationContext::replaceByLocRoute
 
 Config::ConstLocPtr Config::ServerContext::matchLocation
 	(const std::string& path) const {
-			
+
+	return locationTree.match(path);
+
+}
+
+Config::LocationTree::LocationTree() {
+
+	// the root has an empty label
+	mNodes.push_back(Node());
+	mNodes.back().location = NULL;
+
+}
+
+void Config::LocationTree::build
+	(const LocationsCollection& locations) {
+
+	mNodes.resize(1);
+	mNodes[0].location = NULL;
+	mNodes[0].children.clear();
+
+	for (LocationsCollection::const_iterator location
+		= locations.begin(); location != locations.end();
+		++location)
+		insert(location->first, &location->second);
+
+}
+
+void Config::LocationTree::insert(const std::string& path,
+	ConstLocPtr location) {
+
+	size_t node = 0;
+	size_t pos = 0;
+
+	while (pos < path.size()) {
+
+		const std::map<char, size_t>::iterator child
+			= mNodes[node].children.find(path[pos]);
+
+		// no edge starts with the next character
+			// so the rest of the path becomes a new one
+		if (child == mNodes[node].children.end()) {
+
+			Node leaf;
+			leaf.label = path.substr(pos);
+			leaf.location = location;
+
+			mNodes.push_back(leaf);
+			mNodes[node].children[path[pos]] = mNodes.size() - 1;
+			return;
+
+		}
+
+		const size_t next = child->second;
+		const std::string& label = mNodes[next].label;
+
+		// length of the common prefix of
+			// the label and the rest of the path
+		size_t common = 0;
+		while (common < label.size() && pos + common < path.size()
+			&& label[common] == path[pos + common])
+			++common;
+
+		// the edge is split at the end of the common prefix
+		if (common < label.size()) {
+
+			Node middle;
+			middle.label = label.substr(0, common);
+			middle.location = NULL;
+			middle.children[label[common]] = next;
+
+			mNodes[next].label.erase(0, common);
+
+			mNodes.push_back(middle);
+			mNodes[node].children[path[pos]] = mNodes.size() - 1;
+
+			node = mNodes.size() - 1;
+
+		}
+		else
+			node = next;
+
+		pos += common;
+
+	}
+
+	mNodes[node].location = location;
+
+}
+
+Config::ConstLocPtr Config::LocationTree::match
+	(const std::string& path) const {
+
+	// the path is matched as if it ended with a '/', so
+		// that a location ending with '/' matches the
+		// path without it
+	const size_t size = path.size() + 1;
+
 	ConstLocPtr matchedLocation = NULL;
+	size_t node = 0;
+	size_t depth = 0;
+
+	while (true) {
+
+		// a location only matches at a segment boundary: it
+			// either ends with '/' or is followed by '/' in
+			// the path (the empty location matches anything)
+		// the longest one that matches is kept
+		if (mNodes[node].location && (depth == 0
+			|| (depth <= path.size() ? path[depth - 1] : '/') == '/'
+			|| (depth < path.size() ? path[depth] : '/') == '/'))
+			matchedLocation = mNodes[node].location;
 
-	// The search for the matched location will follow this logic:
-	// it will start by matching the whole path against all the
-		// locations, and if no match is found, the trailing slash will
-		// be deleted and the new subpath is stored in subPath and will
-		// be matched again, and if not match is found then the chars
-		// that precede the next slash are deleted, and new subpath is 
-		// tested again. This process will be repeated until a match is
-		// found, or no more chars are left in path 
-	Path subPath = path;
-
-	// append "/" to check the case of location route ending with "/"
-	subPath += "/";
-
-	// checks each prefix subpath within path if it 
-		// matches with a location of the server starting 
-		// from the most specific one
-	size_t pos;
-	while (!subPath.empty()) {
-		// find the pos of the last "/"
-		pos = subPath.rfind("/");
-
-		// search sub path with the / char
-		subPath.erase(pos + 1);
-		matchedLocation = getLocation(subPath);
-		if (matchedLocation)
+		if (depth == size)
 			break;
 
-		// search sub path without the / char
-		subPath.erase(pos);
-		matchedLocation = getLocation(subPath);
-		if (matchedLocation)
+		const char c = depth < path.size() ? path[depth] : '/';
+
+		const std::map<char, size_t>::const_iterator child
+			= mNodes[node].children.find(c);
+
+		if (child == mNodes[node].children.end())
+			break;
+
+		// the whole label needs to match since no
+			// location ends in the middle of an edge
+		const std::string& label = mNodes[child->second].label;
+		if (depth + label.size() > size)
 			break;
+
+		size_t i = 0;
+		while (i < label.size() && label[i]
+			== (depth + i < path.size() ? path[depth + i] : '/'))
+			++i;
+
+		if (i < label.size())
+			break;
+
+		depth += label.size();
+		node = child->second;
+
 	}
 
 	return matchedLocation;
@@ -221,10 +329,20 @@ void Config::printServer(const ServerContext& server, int indent) {
 
 	std::cout << indentStr << "CLIENT_BODY_SIZE_MAX: "
 		<< server.clientBodySizeMax << '\n';
+
+	std::cout << indentStr << "CLIENT_BODY_BUFFER_SIZE: "
+		<< server.clientBodyBufferSize << '\n';
 	
 	std::cout << indentStr << "ERROR_PAGES\n";
 	printMap(server.errorPages, indent + 1);
 
+	std::cout << indentStr << "PREWARM:";
+	for (std::vector<Path>::const_iterator path
+		= server.prewarmPaths.begin();
+		path != server.prewarmPaths.end(); ++path)
+		std::cout << " '" << *path << '\'';
+	std::cout << '\n';
+
 	// taverses location's elements
 	for (LocationsCollection::const_iterator
 		it = server.locations.begin();
@@ -250,6 +368,8 @@ void Config::printLocation(const LocationContext& location, int indent) {
 		std::cout << indentStr + '\t' << "POST\n";
 	if (location.del)
 		std::cout << indentStr + '\t' << "DELETE\n";
+	if (location.put)
+		std::cout << indentStr + '\t' << "PUT\n";
 
 	std::cout << indentStr << "REDIRECTION\n";
 	std::cout << indentStr + '\t' << location.redirection.first
@@ -269,6 +389,49 @@ void Config::printLocation(const LocationContext& location, int indent) {
 	std::cout << indentStr << "UPLOAD: '"
 		<< location.uploadRoute << "'\n";
 
+	std::cout << indentStr << "GZIP_STATIC: "
+		<< (location.gzipStatic ? "ON\n" : "OFF\n");
+
+	std::cout << indentStr << "GZIP: "
+		<< (location.gzip ? "ON\n" : "OFF\n");
+
+	std::cout << indentStr << "GZIP_COMP_LEVEL: "
+		<< location.gzipCompLevel << '\n';
+
+	std::cout << indentStr << "GZIP_MIN_LENGTH: "
+		<< location.gzipMinLength << '\n';
+
+	std::cout << indentStr << "GZIP_TYPES\n";
+	for (std::set<std::string>::const_iterator
+		type = location.gzipTypes.begin();
+		type != location.gzipTypes.end(); ++type)
+		std::cout << indentStr + '\t' << *type << '\n';
+
+	std::cout << indentStr << "EXPIRES: "
+		<< location.expires << '\n';
+
+	std::cout << indentStr << "EXPIRES_TYPE\n";
+	printMap(location.expiresTypes, indent + 1);
+
+	std::cout << indentStr << "CACHE_CONTROL: '"
+		<< location.cacheControl << "'\n";
+
+	std::cout << indentStr << "ASSET_PACK: '"
+		<< location.assetPack << "'\n";
+
+	std::cout << indentStr << "UPLOAD_SYNC: "
+		<< location.uploadSync << ' '
+		<< location.uploadSyncInterval << '\n';
+
+	std::cout << indentStr << "UPLOAD_DIRECT: "
+		<< location.uploadDirect << '\n';
+
+	std::cout << indentStr << "ZEROCOPY: "
+		<< (location.zerocopy ? "ON\n" : "OFF\n");
+
+	std::cout << indentStr << "ZEROCOPY_MIN_SIZE: "
+		<< location.zerocopyMinSize << '\n';
+
 }
 
 template <class Map>
@@ -9,6 +9,8 @@
 #include <map>
 #include <list>
 #include <set>
+#include <vector>
+#include <algorithm>
 #include <stdexcept>
 #include <fstream>
 #include <StatusCodeHandler.hpp>
@@ -29,11 +31,23 @@ class Config {
 		// holds info about a given location
 		struct LocationContext {
 
+			// when the uploaded files are synced to the disk
+			enum SyncPolicy {
+				// left to the kernel
+				SYNC_OFF,
+				// once the body is written
+				SYNC_END,
+				// each uploadSyncInterval bytes
+					// and once the body is written
+				SYNC_PERIODIC
+			};
+
 			Path route;
 			// http methods
 			bool get;
 			bool post;
 			bool del;
+			bool put;
 			// end of http methods
 			std::pair<StatusCode, Path> redirection;
 			Path root;
@@ -41,6 +55,44 @@ class Config {
 			Path defaultFile;
 			CGISystems supportedCGIs;
 			Path uploadRoute;
+			// serve precompressed file.gz/file.br
+				// sidecars when the client accepts them
+			bool gzipStatic;
+			// compress responses on the fly with gzip
+			bool gzip;
+			// gzip compression level (1 to 9)
+			int gzipCompLevel;
+			// responses whose body is shorter
+				// than this aren't compressed
+			Size gzipMinLength;
+			// mime types of the responses
+				// that can be compressed
+			std::set<std::string> gzipTypes;
+			// seconds during which the responses stay
+				// fresh in caches (-1 if not set)
+			long expires;
+			// expires of the responses of specific
+				// mime types (overrides expires)
+			std::map<std::string, long> expiresTypes;
+			// directives added to the Cache-Control header
+				// of the responses (like immutable or no-store)
+			std::string cacheControl;
+			// asset pack from which the location is served
+				// instead of the filesystem (empty if not set)
+			Path assetPack;
+			SyncPolicy uploadSync;
+			// bytes written between two syncs
+				// (with SYNC_PERIODIC)
+			Size uploadSyncInterval;
+			// uploaded files are written with O_DIRECT
+				// (bypassing the page cache)
+			bool uploadDirect;
+			// in-memory bodies are sent with MSG_ZEROCOPY
+				// (the kernel sends them from their pages)
+			bool zerocopy;
+			// bodies shorter than this are
+				// copied to the kernel anyway
+			Size zerocopyMinSize;
 
 			/******* member functions *******/
 			// constructor
@@ -68,6 +120,43 @@ class Config {
 		typedef const LocationContext* ConstLocPtr;
 
 		/******* nested types *******/
+		// compressed radix tree of the location paths of a server
+		// it's built once from the locations when the config is
+			// loaded and finds the location of a path in a single
+			// pass over the path without any allocation, so the cost
+			// of matching doesn't grow with the number of locations
+		class LocationTree {
+
+			public:
+				LocationTree();
+
+				// builds the tree from all the locations
+				void build(const LocationsCollection& locations);
+
+				// same as ServerContext::matchLocation()
+				ConstLocPtr match(const std::string& path) const ;
+
+			private:
+				// an edge of the tree labeled with a part of a
+					// location path ending at this node
+				struct Node {
+					std::string label;
+					// location whose path ends at this node (or NULL)
+					ConstLocPtr location;
+					// indexes in mNodes of the children keyed
+						// by the first character of their label
+					std::map<char, size_t> children;
+				};
+
+				// nodes of the tree starting with the root
+				std::vector<Node> mNodes;
+
+				// adds a location whose path is path
+				void insert(const std::string& path,
+					ConstLocPtr location);
+
+		};
+
 		// holds information about a given server
 		struct ServerContext {
 
@@ -77,16 +166,26 @@ class Config {
 			Socket socketID;
 			std::map<StatusCode, Path> errorPages;
 			Size clientBodySizeMax;
+			// request bodies up to this size are kept in
+				// memory instead of being written to a file
+			Size clientBodyBufferSize;
 			LocationsCollection locations;
+			// requested paths of the files that are loaded
+				// into the page cache at startup
+			std::vector<Path> prewarmPaths;
+			// built from locations once the server is parsed
+			LocationTree locationTree;
 
 			// Config sets hostname and port to these defaults
 				// in case they were not provided in the config file
 			const static std::string defaultHostname;
 			const static std::string defaultPort;
+			const static Size defaultClientBodyBufferSize;
 
 			/******* member functions *******/
 			// constructor
-			// initializes socketID to -1 and clientBodySizeMax to 0
+			// initializes socketID to -1, clientBodySizeMax to 0
+				// and clientBodyBufferSize to its default
 			ServerContext();
 
 			// returns a const ptr to a location context
@@ -97,6 +196,9 @@ class Config {
 
 			// finds the most specific location that matches
 				// a prefix subpath within path
+			// a location ending with '/' is preferred over
+				// the same path without it
+			// it's looked for in locationTree
 			// if not foud, returns NULL
 			ConstLocPtr matchLocation
 				(const std::string& path) const ;
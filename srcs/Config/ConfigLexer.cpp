@@ -133,7 +133,8 @@ bool ConfigLexer::isMethod() {
 
 	return (mCurrentTok.value == "GET"
 		|| mCurrentTok.value == "POST"
-		|| mCurrentTok.value == "DELETE");
+		|| mCurrentTok.value == "DELETE"
+		|| mCurrentTok.value == "PUT");
 
 }
 
@@ -168,6 +169,8 @@ void ConfigLexer::setTypeForNewToken() {
 		mCurrentTok.type = Token::ERR_PAGE;
 	else if (mCurrentTok.value == "client_body_size_max")
 		mCurrentTok.type = Token::CLIENT_MAX;
+	else if (mCurrentTok.value == "client_body_buffer_size")
+		mCurrentTok.type = Token::CLIENT_BUF;
 	else if (mCurrentTok.value == "location")
 		mCurrentTok.type = Token::LOC;
 	else if (mCurrentTok.value == "allow_methods")
@@ -190,6 +193,34 @@ void ConfigLexer::setTypeForNewToken() {
 		mCurrentTok.type = Token::CGI;
 	else if (mCurrentTok.value == "upload")
 		mCurrentTok.type = Token::UPLOAD;
+	else if (mCurrentTok.value == "gzip_static")
+		mCurrentTok.type = Token::GZIP_STATIC;
+	else if (mCurrentTok.value == "gzip")
+		mCurrentTok.type = Token::GZIP;
+	else if (mCurrentTok.value == "gzip_comp_level")
+		mCurrentTok.type = Token::GZIP_LEVEL;
+	else if (mCurrentTok.value == "gzip_min_length")
+		mCurrentTok.type = Token::GZIP_MIN;
+	else if (mCurrentTok.value == "gzip_types")
+		mCurrentTok.type = Token::GZIP_TYPES;
+	else if (mCurrentTok.value == "expires")
+		mCurrentTok.type = Token::EXPIRES;
+	else if (mCurrentTok.value == "expires_type")
+		mCurrentTok.type = Token::EXPIRES_TYPE;
+	else if (mCurrentTok.value == "cache_control")
+		mCurrentTok.type = Token::CACHE_CTRL;
+	else if (mCurrentTok.value == "prewarm")
+		mCurrentTok.type = Token::PREWARM;
+	else if (mCurrentTok.value == "asset_pack")
+		mCurrentTok.type = Token::ASSET_PACK;
+	else if (mCurrentTok.value == "upload_sync")
+		mCurrentTok.type = Token::UPLOAD_SYNC;
+	else if (mCurrentTok.value == "upload_direct")
+		mCurrentTok.type = Token::UPLOAD_DIRECT;
+	else if (mCurrentTok.value == "zerocopy")
+		mCurrentTok.type = Token::ZEROCOPY;
+	else if (mCurrentTok.value == "zerocopy_min_size")
+		mCurrentTok.type = Token::ZEROCOPY_MIN;
 	else if (mCurrentTok.value == "{")
 		mCurrentTok.type = Token::LB;
 	else if (mCurrentTok.value == "}")
@@ -19,6 +19,13 @@ struct Token {
 	 * ALLOW=allow_methods, METHOD= actual method value (GET, POST, ..)
 	 * RDR=redirect, AUTOIN = autoindex, DEFLT=default, EXT=extension
 	 * UPLOAD=upload, LB=left brace, RB=right brace OTHER= anything else
+	 * GZIP_STATIC=gzip_static, GZIP=gzip, GZIP_LEVEL=gzip_comp_level
+	 * GZIP_MIN=gzip_min_length, GZIP_TYPES=gzip_types, EXPIRES=expires
+	 * EXPIRES_TYPE=expires_type, CACHE_CTRL=cache_control
+	 * PREWARM=prewarm, ASSET_PACK=asset_pack
+	 * CLIENT_BUF=client_body_buffer_size, UPLOAD_SYNC=upload_sync
+	 * UPLOAD_DIRECT=upload_direct, ZEROCOPY=zerocopy
+	 * ZEROCOPY_MIN=zerocopy_min_size
 	 */
 	enum Type {
 		SRV_BLK,
@@ -26,6 +33,7 @@ struct Token {
 		LISTEN,
 		ERR_PAGE,
 		CLIENT_MAX,
+		CLIENT_BUF,
 		LOC,
 		ALLOW,
 		METHOD,
@@ -37,6 +45,20 @@ struct Token {
 		EXT,
 		CGI,
 		UPLOAD,
+		GZIP_STATIC,
+		GZIP,
+		GZIP_LEVEL,
+		GZIP_MIN,
+		GZIP_TYPES,
+		EXPIRES,
+		EXPIRES_TYPE,
+		CACHE_CTRL,
+		PREWARM,
+		ASSET_PACK,
+		UPLOAD_SYNC,
+		UPLOAD_DIRECT,
+		ZEROCOPY,
+		ZEROCOPY_MIN,
 		LB,
 		RB,
 		NUM,
@@ -2,6 +2,8 @@
 
 #include <ConfigParser.hpp>
 
+const long ConfigParser::mMaxDuration = 10L * 365 * 24 * 60 * 60;
+
 ConfigParser::ConfigParser(std::istream& input, Config& config)
 	: mConfig(config)
 	, mServers(config.getServers())
@@ -54,6 +56,12 @@ void ConfigParser::parseServer() {
 			case Token::CLIENT_MAX:
 				parseClientBodySizeMax();
 				break;
+			case Token::CLIENT_BUF:
+				parseClientBodyBufferSize();
+				break;
+			case Token::PREWARM:
+				parsePrewarm();
+				break;
 			case Token::LOC:
 				parseLocation();
 				break;
@@ -69,6 +77,9 @@ void ConfigParser::parseServer() {
 
 	defaultInitUnfilledServerFields();
 
+	// all the locations of the server are known
+	mServerRef->locationTree.build(mServerRef->locations);
+
 }
 
 void ConfigParser::parseLocation() {
@@ -123,6 +134,45 @@ void ConfigParser::parseLocation() {
 			case Token::UPLOAD:
 				parseUpload();
 				break;
+			case Token::GZIP_STATIC:
+				parseGzipStatic();
+				break;
+			case Token::GZIP:
+				parseGzip();
+				break;
+			case Token::GZIP_LEVEL:
+				parseGzipCompLevel();
+				break;
+			case Token::GZIP_MIN:
+				parseGzipMinLength();
+				break;
+			case Token::GZIP_TYPES:
+				parseGzipTypes();
+				break;
+			case Token::EXPIRES:
+				parseExpires();
+				break;
+			case Token::EXPIRES_TYPE:
+				parseExpiresType();
+				break;
+			case Token::CACHE_CTRL:
+				parseCacheControl();
+				break;
+			case Token::ASSET_PACK:
+				parseAssetPack();
+				break;
+			case Token::UPLOAD_SYNC:
+				parseUploadSync();
+				break;
+			case Token::UPLOAD_DIRECT:
+				parseUploadDirect();
+				break;
+			case Token::ZEROCOPY:
+				parseZeroCopy();
+				break;
+			case Token::ZEROCOPY_MIN:
+				parseZeroCopyMinSize();
+				break;
 			default:
 				handleParsingError(token);
 		}
@@ -216,6 +266,8 @@ void ConfigParser::addMethod(const Token& token) {
 		mLocationRef->post = true;
 	else if (token.value == "DELETE")
 		mLocationRef->del = true;
+	else if (token.value == "PUT")
+		mLocationRef->put = true;
 	
 }
 
@@ -371,21 +423,301 @@ void ConfigParser::parseUpload() {
 
 }
 
-void ConfigParser::parseAutoIndex() {
+void ConfigParser::parseAssetPack() {
+
+	parsePath(mLocationRef->assetPack);
+
+	// the pack itself is mapped and checked
+		// when the server starts
+	if (!isPathRead(mLocationRef->assetPack)
+		|| isDir(mLocationRef->assetPack)) {
+		std::string error = mLocationRef->assetPack;
+		error += " is not a readable file";
+		mServers.clear();
+		throw std::runtime_error(error);
+	}
+
+}
+
+void ConfigParser::parseUploadSync() {
+
+	Token token = mLexer.next();
+
+	if (token.value == "off")
+		mLocationRef->uploadSync = LocationContext::SYNC_OFF;
+	else if (token.value == "end")
+		mLocationRef->uploadSync = LocationContext::SYNC_END;
+	// a size means that the file is synced
+		// each time that many bytes are written
+	else {
+
+		isNum(token);
+
+		try {
+			mLocationRef->uploadSyncInterval =
+				strToNum<Size>(token.value);
+		}
+		catch (const std::exception& error) {
+			std::cerr << error.what() << '\n';
+			handleParsingError(token);
+		}
+
+		if (mLocationRef->uploadSyncInterval == 0) {
+			std::cerr << "upload_sync interval can't be 0\n";
+			handleParsingError(token);
+		}
+
+		mLocationRef->uploadSync = LocationContext::SYNC_PERIODIC;
+
+	}
+
+	token = mLexer.next();
+	isSemiColon(token);
+
+}
+
+void ConfigParser::parseUploadDirect() {
+	parseSwitch(mLocationRef->uploadDirect);
+}
+
+void ConfigParser::parseZeroCopy() {
+	parseSwitch(mLocationRef->zerocopy);
+}
+
+void ConfigParser::parseZeroCopyMinSize() {
+
+	Token token = mLexer.next();
+	// size must be expressed as a positive number
+	isNum(token);
+
+	// converts token's value to number of type Size
+	try {
+		mLocationRef->zerocopyMinSize =
+			strToNum<Size>(token.value);
+	}
+	catch (const std::exception& error) {
+		std::cerr << error.what() << '\n';
+		handleParsingError(token);
+	}
+
+	token = mLexer.next();
+	isSemiColon(token);
+
+}
+
+void ConfigParser::parseSwitch(bool& switchLoc) {
 
 	Token token = mLexer.next();
 	isSwitch(token);
 
-	if (token.value == "on")
-		mLocationRef->autoindex = true;
-	else
-		mLocationRef->autoindex = false;
+	switchLoc = (token.value == "on");
+
+	token = mLexer.next();
+	isSemiColon(token);
+
+}
+
+void ConfigParser::parseAutoIndex() {
+	parseSwitch(mLocationRef->autoindex);
+}
+
+void ConfigParser::parseGzipStatic() {
+	parseSwitch(mLocationRef->gzipStatic);
+}
+
+void ConfigParser::parseGzip() {
+	parseSwitch(mLocationRef->gzip);
+}
+
+void ConfigParser::parseGzipCompLevel() {
+
+	Token token = mLexer.next();
+	// level must be expressed as a positive number
+	isNum(token);
+
+	// only levels from 1 to 9 are valid
+	if (token.value.size() != 1 || token.value[0] == '0') {
+		std::cerr << "gzip_comp_level must be between 1 and 9\n";
+		handleParsingError(token);
+	}
+
+	mLocationRef->gzipCompLevel = token.value[0] - '0';
 
 	token = mLexer.next();
 	isSemiColon(token);
 
 }
 
+void ConfigParser::parseGzipMinLength() {
+
+	Token token = mLexer.next();
+	// length must be expressed as a positive number
+	isNum(token);
+
+	// converts token's value to number of type Size
+	try {
+		mLocationRef->gzipMinLength =
+			strToNum<Size>(token.value);
+	}
+	catch (const std::exception& error) {
+		std::cerr << error.what() << '\n';
+		handleParsingError(token);
+	}
+
+	token = mLexer.next();
+	isSemiColon(token);
+
+}
+
+void ConfigParser::parseGzipTypes() {
+
+	// the directive replaces the default types
+	mLocationRef->gzipTypes.clear();
+
+	Token token = mLexer.next();
+	// there should be at least one mime type (type/subtype)
+	do {
+
+		isNotEOS(token);
+		isNotAKeyword(token);
+
+		if (token.value.find('/') == std::string::npos)
+			handleParsingError(token);
+
+		std::string type = token.value;
+		for (std::string::size_type i = 0; i < type.size(); ++i)
+			type[i] = std::tolower(type[i]);
+
+		mLocationRef->gzipTypes.insert(type);
+
+		token = mLexer.next();
+
+	} while (token.type != Token::SM_COL);
+
+}
+
+void ConfigParser::parseExpires() {
+
+	Token token = mLexer.next();
+	parseDuration(token, mLocationRef->expires);
+
+	token = mLexer.next();
+	isSemiColon(token);
+
+}
+
+void ConfigParser::parseExpiresType() {
+
+	Token token = mLexer.next();
+	isNotEOS(token);
+	isNotAKeyword(token);
+
+	// the first argument is a mime type (type/subtype)
+	if (token.value.find('/') == std::string::npos)
+		handleParsingError(token);
+
+	std::string type = token.value;
+	for (std::string::size_type i = 0; i < type.size(); ++i)
+		type[i] = std::tolower(type[i]);
+
+	token = mLexer.next();
+	parseDuration(token, mLocationRef->expiresTypes[type]);
+
+	token = mLexer.next();
+	isSemiColon(token);
+
+}
+
+void ConfigParser::parseCacheControl() {
+
+	mLocationRef->cacheControl.clear();
+
+	Token token = mLexer.next();
+	// there should be at least one cache directive
+	do {
+
+		isNotEOS(token);
+		isNotAKeyword(token);
+
+		if (mLocationRef->cacheControl.empty() == false)
+			mLocationRef->cacheControl += ", ";
+
+		for (std::string::size_type i = 0; i < token.value.size(); ++i)
+			mLocationRef->cacheControl += std::tolower(token.value[i]);
+
+		token = mLexer.next();
+
+	} while (token.type != Token::SM_COL);
+
+}
+
+void ConfigParser::parseDuration(const Token& token, long& durationLoc) {
+
+	// no expiry
+	if (token.value == "off") {
+		durationLoc = -1;
+		return;
+	}
+
+	if (token.value == "max") {
+		durationLoc = mMaxDuration;
+		return;
+	}
+
+	isNotEOS(token);
+	isNotAKeyword(token);
+
+	long duration = 0;
+
+	// a duration is a sequence of numbers that are
+		// each followed by an optional unit (ex: 1h30m)
+	std::string::size_type i = 0;
+	while (i < token.value.size()) {
+
+		if (std::isdigit(token.value[i]) == false)
+			handleParsingError(token);
+
+		long number = 0;
+		for (; i < token.value.size()
+			&& std::isdigit(token.value[i]); ++i) {
+
+			number = number * 10 + (token.value[i] - '0');
+
+			if (number > mMaxDuration)
+				handleParsingError(token);
+
+		}
+
+		// seconds if there is no unit
+		long unit = 1;
+		if (i < token.value.size()) {
+
+			switch (token.value[i++]) {
+				case 's': unit = 1; break;
+				case 'm': unit = 60; break;
+				case 'h': unit = 60 * 60; break;
+				case 'd': unit = 24 * 60 * 60; break;
+				case 'w': unit = 7 * 24 * 60 * 60; break;
+				case 'y': unit = 365 * 24 * 60 * 60; break;
+				default:
+					std::cerr << "durations can only use these "
+						"units: s, m, h, d, w, y\n";
+					handleParsingError(token);
+			}
+
+		}
+
+		if (number > (mMaxDuration - duration) / unit)
+			handleParsingError(token);
+
+		duration += number * unit;
+
+	}
+
+	durationLoc = duration;
+
+}
+
 void ConfigParser::isToken(const Token& token, Token::Type type) {
 
 	if (token.type != type)
@@ -427,6 +759,7 @@ void ConfigParser::isNotAKeyword(const Token& token) {
 		case Token::LISTEN:
 		case Token::ERR_PAGE:
 		case Token::CLIENT_MAX:
+		case Token::CLIENT_BUF:
 		case Token::LOC:
 		case Token::ALLOW:
 		case Token::RDR:
@@ -435,6 +768,20 @@ void ConfigParser::isNotAKeyword(const Token& token) {
 		case Token::DFLT:
 		case Token::CGI:
 		case Token::UPLOAD:
+		case Token::GZIP_STATIC:
+		case Token::GZIP:
+		case Token::GZIP_LEVEL:
+		case Token::GZIP_MIN:
+		case Token::GZIP_TYPES:
+		case Token::EXPIRES:
+		case Token::EXPIRES_TYPE:
+		case Token::CACHE_CTRL:
+		case Token::PREWARM:
+		case Token::ASSET_PACK:
+		case Token::UPLOAD_SYNC:
+		case Token::UPLOAD_DIRECT:
+		case Token::ZEROCOPY:
+		case Token::ZEROCOPY_MIN:
 		case Token::LB:
 		case Token::RB:
 		case Token::SM_COL:
@@ -467,7 +814,7 @@ void ConfigParser::defaultInitUnfilledLocationFields() {
 	// if no method was allowed for location, then the
 		// the default is to enable get method
 	if (!mLocationRef->get && !mLocationRef->post
-		&& !mLocationRef->del)
+		&& !mLocationRef->del && !mLocationRef->put)
 		mLocationRef->get = true;
 
 	// if no root path was specified,
@@ -478,6 +825,21 @@ void ConfigParser::defaultInitUnfilledLocationFields() {
 		mLocationRef->root += '/';
 	}
 
+	// if no gzip type was specified, the
+		// common textual types are compressed
+	if (mLocationRef->gzipTypes.empty()) {
+
+		const char* defaultTypes[] = {
+			"text/html", "text/css", "text/plain", "text/xml",
+			"application/javascript", "application/json",
+			"image/svg+xml"
+		};
+
+		mLocationRef->gzipTypes.insert(defaultTypes, defaultTypes
+			+ sizeof(defaultTypes) / sizeof(defaultTypes[0]));
+
+	}
+
 }
 
 bool ConfigParser::isStrNumerical(const std::string& str) {
@@ -546,6 +908,28 @@ void ConfigParser::parseListen() {
 
 }
 		
+void ConfigParser::parsePrewarm() {
+
+	Token token = mLexer.next();
+	// there should be at least one path
+	do {
+
+		isNotEOS(token);
+		isNotAKeyword(token);
+
+		// paths are requested paths that are resolved
+			// through the locations of the server
+		if (token.value.empty() || token.value[0] != '/')
+			handleParsingError(token);
+
+		mServerRef->prewarmPaths.push_back(token.value);
+
+		token = mLexer.next();
+
+	} while (token.type != Token::SM_COL);
+
+}
+
 void ConfigParser::parseErrorPage() {
 
 	// set status code classes that are supported by the error_page directive
@@ -579,6 +963,14 @@ void ConfigParser::parseErrorPage() {
 }
 
 void ConfigParser::parseClientBodySizeMax() {
+	parseSize(mServerRef->clientBodySizeMax);
+}
+
+void ConfigParser::parseClientBodyBufferSize() {
+	parseSize(mServerRef->clientBodyBufferSize);
+}
+
+void ConfigParser::parseSize(Size& size) {
 
 	Token token = mLexer.next();
 	// size must be expressed as a positive number
@@ -586,8 +978,7 @@ void ConfigParser::parseClientBodySizeMax() {
 
 	// converts token's value to number of type Size
 	try {
-		mServerRef->clientBodySizeMax =
-			strToNum<Size>(token.value);
+		size = strToNum<Size>(token.value);
 	}
 	catch (const std::exception& error) {
 		std::cerr << error.what() << '\n';
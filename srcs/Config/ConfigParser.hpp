@@ -59,6 +59,10 @@ class ConfigParser {
 
 		ConfigLexer mLexer;
 
+		// duration set by the 'max' argument of the expires
+			// directives which is also the longest one (10 years)
+		static const long mMaxDuration;
+
 		/******* private member functions *******/
 		/* the parse*() member functions parse directives in their scope.
 		 * if a directive or token doesn't belong to that scope, a call
@@ -186,6 +190,16 @@ class ConfigParser {
 			// size argument fails
 		void parseClientBodySizeMax();
 
+		void parseClientBodyBufferSize();
+
+		// parses a size argument into size followed by a
+			// semi-colon (used by the size directives)
+		void parseSize(Size& size);
+
+		// parses the paths of the prewarm directive
+			// (at least one) which must start with '/'
+		void parsePrewarm();
+
 		// parses a path token and ensures that the
 			// token that follows it is a semi-colon
 		// if a leading slash doesn't exist in the path
@@ -206,12 +220,57 @@ class ConfigParser {
 			// is printed to stderr and handleParsingError() is called
 		void parseRedirection();
 
+		// parses a switch token (on or off) and ensures
+			// that the token that follows it is a semi-colon
+		// it is used by directives that take a switch
+			// as their one and only argument
+		// the switchLoc argument is set to true if the
+			// switch is on, otherwise to false
+		void parseSwitch(bool& switchLoc);
+
 		// parses path used as an alias path of the location path
 		void parseRoot();
 
 		// parses the switch status of autoindex directive (on or off)
 		void parseAutoIndex();
 
+		// parses the switch status of gzip_static directive (on or off)
+		void parseGzipStatic();
+
+		// parses the switch status of gzip directive (on or off)
+		void parseGzip();
+
+		// parses the compression level of the gzip_comp_level
+			// directive which should be from 1 to 9
+		void parseGzipCompLevel();
+
+		// prints error msg to stderr if a conversion of the
+			// length argument fails
+		void parseGzipMinLength();
+
+		// parses the list of mime types (type/subtype)
+			// of gzip_types directive
+		void parseGzipTypes();
+
+		// parses the duration of the expires directive
+		void parseExpires();
+
+		// parses the mime type and duration of
+			// expires_type directive
+		void parseExpiresType();
+
+		// parses the list of directives of the cache_control
+			// directive (like public, immutable or no-store)
+		void parseCacheControl();
+
+		// parses the duration in token which is either 'off',
+			// 'max' or a sequence of numbers that are each
+			// followed by an optional unit (s, m, h, d, w, y)
+			// like 30d or 1h30m
+		// stores the duration in seconds in durationLoc
+			// (-1 for 'off')
+		void parseDuration(const Token& token, long& durationLoc);
+
 		// parses path specified in the default directive
 		void parseDefault();
 
@@ -226,4 +285,22 @@ class ConfigParser {
 			// throws a std::runtime_error
 		void parseUpload();
 
+		// parses the path of the asset pack served by the location
+		// if it isn't a readable file, clears mServers and
+			// throws a std::runtime_error
+		void parseAssetPack();
+
+		// parses the sync policy of the uploads which is
+			// off, end or a size (the interval of the syncs)
+		void parseUploadSync();
+
+		void parseUploadDirect();
+
+		// parses the switch status of zerocopy directive (on or off)
+		void parseZeroCopy();
+
+		// prints error msg to stderr if a conversion of the
+			// size argument fails
+		void parseZeroCopyMinSize();
+
 };
@@ -0,0 +1,99 @@
+/* this file contains the implementation of the GzipCache class */
+
+#include <GzipCache.hpp>
+
+GzipCache::Entries GzipCache::mEntries;
+
+size_t GzipCache::mTotalSize = 0;
+
+unsigned long GzipCache::mUseCounter = 0;
+
+const size_t GzipCache::mMaxTotalSize = 32 * 1024 * 1024;
+
+const size_t GzipCache::mMaxEntrySize = 4 * 1024 * 1024;
+
+bool GzipCache::find(const std::string& path,
+	const std::time_t modTime, const size_t size,
+	const int level, SharedBuffer& buffer) {
+
+	const Entries::iterator entry = mEntries.find(path);
+
+	if (entry == mEntries.end())
+		return false;
+
+	// the file changed since it was compressed
+		// so the entry can't be used anymore
+	if (entry->second.modTime != modTime
+		|| entry->second.size != size) {
+		erase(entry);
+		return false;
+	}
+
+	if (entry->second.level != level)
+		return false;
+
+	entry->second.lastUse = ++mUseCounter;
+	buffer = entry->second.buffer;
+
+	return true;
+
+}
+
+void GzipCache::store(const std::string& path,
+	const std::time_t modTime, const size_t size,
+	const int level, std::string& compressed) {
+
+	if (compressed.size() > mMaxEntrySize)
+		return;
+
+	// replaces any older version of the file
+	const Entries::iterator oldEntry = mEntries.find(path);
+	if (oldEntry != mEntries.end())
+		erase(oldEntry);
+
+	evict(compressed.size());
+
+	Entry& entry = mEntries[path];
+	entry.modTime = modTime;
+	entry.size = size;
+	entry.level = level;
+	entry.buffer = SharedBuffer(compressed);
+	entry.lastUse = ++mUseCounter;
+
+	mTotalSize += entry.buffer.getSize();
+
+}
+
+size_t GzipCache::getMaxEntrySize() {
+	return mMaxEntrySize;
+}
+
+void GzipCache::erase(Entries::iterator entry) {
+
+	// the buffer stays alive for the
+		// responses that are still sending it
+	mTotalSize -= entry->second.buffer.getSize();
+	mEntries.erase(entry);
+
+}
+
+void GzipCache::evict(const size_t size) {
+
+	while (mEntries.empty() == false
+		&& mTotalSize + size > mMaxTotalSize) {
+
+		Entries::iterator leastRecent = mEntries.begin();
+
+		for (Entries::iterator entry = mEntries.begin();
+			entry != mEntries.end(); ++entry) {
+
+			if (entry->second.lastUse < leastRecent->second.lastUse)
+				leastRecent = entry;
+
+		}
+
+		erase(leastRecent);
+
+	}
+
+}
@@ -0,0 +1,80 @@
+/* this file contains the definition of the GzipCache class
+ * It keeps in memory the gzip compressed versions of the static
+ *  files that were served with on-the-fly compression so that a
+ *  hot file is only compressed once
+ * An entry is keyed by the path of the file and is only valid for
+ *  the modification time, size and compression level it was
+ *  generated with, so a modified file is compressed again
+ * The total size of the entries is bounded and the least recently
+ *  used ones are evicted to make room for new ones
+ */
+
+#pragma once
+
+#include <string>
+#include <map>
+#include <ctime>
+#include <SharedBuffer.hpp>
+
+class GzipCache {
+
+	public:
+		/******* public member functions *******/
+		// looks for the compressed version of path that was
+			// generated for the given modification time,
+			// size and compression level
+		// returns true and sets buffer to it if one is found
+		static bool find(const std::string& path,
+			const std::time_t modTime, const size_t size,
+			const int level, SharedBuffer& buffer);
+
+		// stores the compressed version of path (compressed is
+			// left empty since its content is taken over)
+		// it has no effect if compressed is larger than
+			// the maximum entry size
+		static void store(const std::string& path,
+			const std::time_t modTime, const size_t size,
+			const int level, std::string& compressed);
+
+		// returns the maximum size of a single entry
+		static size_t getMaxEntrySize();
+
+	private:
+		/******* private nested types *******/
+		struct Entry {
+			std::time_t modTime;
+			size_t size;
+			int level;
+			SharedBuffer buffer;
+			// value of mUseCounter when the
+				// entry was last used
+			unsigned long lastUse;
+		};
+
+		/******* alias types *******/
+		typedef std::map<std::string, Entry> Entries;
+
+		/******* private member objects *******/
+		static Entries mEntries;
+
+		// sum of the sizes of all the stored buffers
+		static size_t mTotalSize;
+
+		// incremented on every use of an entry
+		static unsigned long mUseCounter;
+
+		// maximum sum of the sizes of all the entries
+		static const size_t mMaxTotalSize;
+
+		// maximum size of a single entry
+		static const size_t mMaxEntrySize;
+
+		/******* private member functions *******/
+		// removes entry from the cache
+		static void erase(Entries::iterator entry);
+
+		// evicts the least recently used entries until
+			// size more bytes can be stored
+		static void evict(const size_t size);
+
+};
@@ -0,0 +1,357 @@
+/* this file contains the implementation of the GzipEncoder class */
+
+#include <GzipEncoder.hpp>
+
+const size_t GzipEncoder::mWindowSize = 32768;
+
+const size_t GzipEncoder::mHashSize = 32768;
+
+const size_t GzipEncoder::mMinMatch = 3;
+
+const size_t GzipEncoder::mMaxMatch = 258;
+
+unsigned long GzipEncoder::mCrcTable[256];
+
+bool GzipEncoder::mIsCrcTableSet = false;
+
+GzipEncoder::GzipEncoder()
+	: mBitBuffer()
+	, mBitCount()
+	, mIsHeaderWritten()
+	, mWindowStart()
+	, mNextHashPos()
+	, mCrc()
+	, mInputSize()
+	, mMaxChainLength()
+	, mNiceLength() {}
+
+void GzipEncoder::start(const int level) {
+
+	// hash chain links followed and nice match
+		// length for each compression level
+	static const int chainLengths[] =
+		{4, 8, 16, 32, 64, 128, 256, 1024, 4096};
+	static const size_t niceLengths[] =
+		{8, 16, 32, 64, 128, 128, 258, 258, 258};
+
+	int index = level - 1;
+	if (index < 0)
+		index = 0;
+	else if (index > 8)
+		index = 8;
+
+	mMaxChainLength = chainLengths[index];
+	mNiceLength = niceLengths[index];
+
+	if (mIsCrcTableSet == false)
+		setCrcTable();
+
+	mBitBuffer = 0;
+	mBitCount = 0;
+	mIsHeaderWritten = false;
+	mWindow.clear();
+	mWindowStart = 0;
+	mNextHashPos = 0;
+	mHead.assign(mHashSize, 0);
+	mPrev.assign(mWindowSize, 0);
+	mCrc = 0xFFFFFFFFUL;
+	mInputSize = 0;
+
+}
+
+void GzipEncoder::compress(const char* data, const size_t size,
+	std::string& output) {
+
+	if (mIsHeaderWritten == false)
+		writeHeader(output);
+
+	if (size == 0)
+		return;
+
+	updateCrc(data, size);
+	mInputSize = (mInputSize + size) & 0xFFFFFFFFUL;
+
+	mWindow.insert(mWindow.end(), data, data + size);
+
+	const size_t end = mWindowStart + mWindow.size();
+	size_t position = end - size;
+
+	// starts a non final block that
+		// uses the fixed Huffman codes
+	writeBits(0, 1, output);
+	writeBits(1, 2, output);
+
+	while (position < end) {
+
+		// the positions that were skipped by the
+			// previous match are added to the chains
+		insertHashes(position);
+
+		size_t length = 0;
+		size_t distance = 0;
+
+		if (end - position >= mMinMatch)
+			length = findMatch(position,
+				std::min(mMaxMatch, end - position), distance);
+
+		if (length) {
+			writeMatch(length, distance, output);
+			position += length;
+		}
+		else {
+			writeSymbol(mWindow[position - mWindowStart], output);
+			++position;
+		}
+
+	}
+
+	// end of block
+	writeSymbol(256, output);
+
+	// only the last mWindowSize bytes can
+		// be referenced by the next chunks
+	if (mWindow.size() > mWindowSize) {
+
+		const size_t excess = mWindow.size() - mWindowSize;
+		mWindow.erase(mWindow.begin(), mWindow.begin() + excess);
+		mWindowStart += excess;
+
+	}
+
+}
+
+void GzipEncoder::finish(std::string& output) {
+
+	if (mIsHeaderWritten == false)
+		writeHeader(output);
+
+	// an empty final block
+	writeBits(1, 1, output);
+	writeBits(1, 2, output);
+	writeSymbol(256, output);
+
+	// pads the last byte with zero bits
+	if (mBitCount)
+		writeBits(0, 8 - mBitCount, output);
+
+	writeUint32(mCrc ^ 0xFFFFFFFFUL, output);
+	writeUint32(mInputSize, output);
+
+	mWindow.clear();
+	mHead.clear();
+	mPrev.clear();
+
+}
+
+void GzipEncoder::writeHeader(std::string& output) {
+
+	// magic number, deflate method, no flags, no
+		// modification time, no extra flags, unix OS
+	static const char header[] =
+		{'\x1f', '\x8b', '\x08', 0, 0, 0, 0, 0, 0, '\x03'};
+
+	output.append(header, sizeof(header));
+
+	mIsHeaderWritten = true;
+
+}
+
+void GzipEncoder::writeBits(const unsigned long value,
+	const int count, std::string& output) {
+
+	mBitBuffer |= value << mBitCount;
+	mBitCount += count;
+
+	while (mBitCount >= 8) {
+		output += static_cast<char>(mBitBuffer & 0xFF);
+		mBitBuffer >>= 8;
+		mBitCount -= 8;
+	}
+
+}
+
+void GzipEncoder::writeCode(const unsigned long code,
+	const int length, std::string& output) {
+
+	// Huffman codes are packed starting with their most
+		// significant bit so they are reversed first
+	unsigned long reversed = 0;
+	for (int i = 0; i < length; ++i)
+		reversed = (reversed << 1) | ((code >> i) & 1);
+
+	writeBits(reversed, length, output);
+
+}
+
+void GzipEncoder::writeSymbol(const unsigned int symbol,
+	std::string& output) {
+
+	// fixed Huffman codes (RFC 1951 section 3.2.6)
+	if (symbol < 144)
+		writeCode(0x30 + symbol, 8, output);
+	else if (symbol < 256)
+		writeCode(0x190 + symbol - 144, 9, output);
+	else if (symbol < 280)
+		writeCode(symbol - 256, 7, output);
+	else
+		writeCode(0xC0 + symbol - 280, 8, output);
+
+}
+
+void GzipEncoder::writeMatch(const size_t length,
+	const size_t distance, std::string& output) {
+
+	static const size_t lengthBases[] = {3, 4, 5, 6, 7, 8, 9,
+		10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67,
+		83, 99, 115, 131, 163, 195, 227, 258};
+	static const int lengthExtraBits[] = {0, 0, 0, 0, 0, 0, 0,
+		0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5,
+		5, 5, 5, 0};
+	static const size_t distanceBases[] = {1, 2, 3, 4, 5, 7, 9,
+		13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769,
+		1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385,
+		24577};
+	static const int distanceExtraBits[] = {0, 0, 0, 0, 1, 1, 2,
+		2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11,
+		11, 12, 12, 13, 13};
+
+	int lengthCode = 28;
+	while (lengthBases[lengthCode] > length)
+		--lengthCode;
+
+	writeSymbol(257 + lengthCode, output);
+	writeBits(length - lengthBases[lengthCode],
+		lengthExtraBits[lengthCode], output);
+
+	int distanceCode = 29;
+	while (distanceBases[distanceCode] > distance)
+		--distanceCode;
+
+	// distance codes are all 5 bits long
+	writeCode(distanceCode, 5, output);
+	writeBits(distance - distanceBases[distanceCode],
+		distanceExtraBits[distanceCode], output);
+
+}
+
+void GzipEncoder::writeUint32(const unsigned long value,
+	std::string& output) {
+
+	for (int i = 0; i < 4; ++i)
+		output += static_cast<char>((value >> (i * 8)) & 0xFF);
+
+}
+
+void GzipEncoder::insertHashes(const size_t end) {
+
+	const size_t windowEnd = mWindowStart + mWindow.size();
+
+	while (mNextHashPos < end
+		&& mNextHashPos + mMinMatch <= windowEnd) {
+
+		const size_t hash = getHash(mNextHashPos);
+
+		mPrev[mNextHashPos % mWindowSize] = mHead[hash];
+		mHead[hash] = mNextHashPos + 1;
+
+		++mNextHashPos;
+
+	}
+
+}
+
+size_t GzipEncoder::getHash(const size_t position) const {
+
+	const unsigned char* bytes = &mWindow[position - mWindowStart];
+
+	const unsigned long value = (static_cast<unsigned long>(bytes[0]) << 16)
+		| (static_cast<unsigned long>(bytes[1]) << 8) | bytes[2];
+
+	// multiplicative hashing keeps the 15 high bits
+		// of the 32-bit product
+	return (((value * 2654435761UL) & 0xFFFFFFFFUL) >> 17)
+		& (mHashSize - 1);
+
+}
+
+size_t GzipEncoder::findMatch(const size_t position,
+	const size_t maxLength, size_t& distance) const {
+
+	const unsigned char* current = &mWindow[position - mWindowStart];
+
+	size_t candidate = mHead[getHash(position)];
+	size_t bestLength = 0;
+
+	for (int chainLength = mMaxChainLength;
+		candidate && chainLength > 0; --chainLength) {
+
+		const size_t candidatePos = candidate - 1;
+
+		// older strings are out of reach
+		if (candidatePos >= position
+			|| candidatePos < mWindowStart
+			|| position - candidatePos > mWindowSize)
+			break;
+
+		const unsigned char* previous
+			= &mWindow[candidatePos - mWindowStart];
+
+		// a longer match must at least agree
+			// on the byte after the best one
+		if (previous[bestLength] == current[bestLength]) {
+
+			size_t length = 0;
+			while (length < maxLength
+				&& previous[length] == current[length])
+				++length;
+
+			if (length > bestLength) {
+
+				bestLength = length;
+				distance = position - candidatePos;
+
+				if (bestLength >= mNiceLength
+					|| bestLength == maxLength)
+					break;
+
+			}
+
+		}
+
+		const size_t next = mPrev[candidatePos % mWindowSize];
+
+		// the link was overwritten by a newer string
+		if (next >= candidate)
+			break;
+
+		candidate = next;
+
+	}
+
+	return (bestLength >= mMinMatch ? bestLength : 0);
+
+}
+
+void GzipEncoder::updateCrc(const char* data, const size_t size) {
+
+	for (size_t i = 0; i < size; ++i)
+		mCrc = mCrcTable[(mCrc ^ static_cast<unsigned char>(data[i]))
+			& 0xFF] ^ (mCrc >> 8);
+
+}
+
+void GzipEncoder::setCrcTable() {
+
+	for (unsigned long n = 0; n < 256; ++n) {
+
+		unsigned long c = n;
+		for (int k = 0; k < 8; ++k)
+			c = c & 1 ? 0xEDB88320UL ^ (c >> 1) : c >> 1;
+
+		mCrcTable[n] = c;
+
+	}
+
+	mIsCrcTableSet = true;
+
+}
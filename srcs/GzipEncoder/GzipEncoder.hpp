@@ -0,0 +1,153 @@
+/* this file contains the definition of the GzipEncoder class
+ * It compresses a stream of bytes into the gzip format (RFC 1952)
+ *  using the deflate algorithm (RFC 1951) without any external
+ *  library. The input can be passed incrementally in chunks of any
+ *  size and the compressed bytes are produced as each chunk arrives,
+ *  so the whole input never needs to be held in memory.
+ * Each chunk is encoded as a deflate block with the fixed Huffman
+ *  codes, and its repeated strings are replaced by back references
+ *  that are found with hash chains over the last 32KB of the stream
+ * The compression level (1 to 9) controls how long the hash chains
+ *  are searched for the longest match
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+class GzipEncoder {
+
+	public:
+		/******* public member functions *******/
+		GzipEncoder();
+
+		// resets the encoder so that a new gzip
+			// stream is started with level
+		// level is clamped to the range [1, 9]
+		void start(const int level);
+
+		// compresses size bytes of data and appends the
+			// compressed bytes to output
+		// the gzip header is appended before the first chunk
+		void compress(const char* data, const size_t size,
+			std::string& output);
+
+		// appends the last deflate block and the gzip
+			// trailer to output which ends the stream
+		// the encoder needs to be started again before
+			// it's used for another stream
+		void finish(std::string& output);
+
+	private:
+		/******* private member objects *******/
+		// bits that were encoded but don't fill
+			// a whole byte yet
+		unsigned long mBitBuffer;
+
+		// number of bits in mBitBuffer
+		int mBitCount;
+
+		// set when the gzip header was written
+		bool mIsHeaderWritten;
+
+		// last bytes of the stream in which back references
+			// can point (at most mWindowSize bytes of history
+			// followed by the chunk being compressed)
+		std::vector<unsigned char> mWindow;
+
+		// position within the whole stream
+			// of the first byte of mWindow
+		size_t mWindowStart;
+
+		// stream position of the next byte that needs
+			// to be added to the hash chains
+		size_t mNextHashPos;
+
+		// for each hash value, the stream position + 1 of the
+			// most recent 3-byte string with that hash (0 if none)
+		std::vector<size_t> mHead;
+
+		// for each stream position (modulo mWindowSize), the
+			// position + 1 of the previous string with
+			// the same hash (0 if none)
+		std::vector<size_t> mPrev;
+
+		// crc32 of the uncompressed data
+		unsigned long mCrc;
+
+		// size of the uncompressed data (modulo 2^32)
+		unsigned long mInputSize;
+
+		// maximum number of hash chain links that are
+			// followed when looking for a match
+		int mMaxChainLength;
+
+		// the search for a match stops as soon as
+			// one of this length is found
+		size_t mNiceLength;
+
+		// maximum distance of a back reference
+		static const size_t mWindowSize;
+
+		// number of hash chains
+		static const size_t mHashSize;
+
+		// minimum and maximum lengths of a back reference
+		static const size_t mMinMatch;
+		static const size_t mMaxMatch;
+
+		static unsigned long mCrcTable[256];
+
+		static bool mIsCrcTableSet;
+
+		/******* private member functions *******/
+		// appends the 10-byte gzip header to output
+		void writeHeader(std::string& output);
+
+		// appends count bits of value to output starting
+			// with the least significant one
+		void writeBits(const unsigned long value, const int count,
+			std::string& output);
+
+		// appends a Huffman code of length bits to output
+			// starting with the most significant one
+		void writeCode(const unsigned long code, const int length,
+			std::string& output);
+
+		// appends the fixed Huffman code of a literal/length
+			// symbol (0 to 287) to output
+		void writeSymbol(const unsigned int symbol,
+			std::string& output);
+
+		// appends the codes of a back reference
+			// of length bytes at distance to output
+		void writeMatch(const size_t length, const size_t distance,
+			std::string& output);
+
+		// appends value to output as 4 little endian bytes
+		void writeUint32(const unsigned long value,
+			std::string& output);
+
+		// adds to the hash chains all the positions before end
+			// that are followed by at least 3 bytes in mWindow
+		void insertHashes(const size_t end);
+
+		// returns the hash of the 3 bytes at stream position
+		size_t getHash(const size_t position) const;
+
+		// finds the longest earlier string that matches
+			// the bytes at position (up to maxLength bytes)
+		// returns its length and sets distance to how far
+			// back it is, or returns 0 if there is none
+		size_t findMatch(const size_t position, const size_t maxLength,
+			size_t& distance) const;
+
+		// updates mCrc with size bytes of data
+		void updateCrc(const char* data, const size_t size);
+
+		static void setCrcTable();
+
+};
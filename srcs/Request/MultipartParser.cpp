@@ -0,0 +1,447 @@
+/* this file contains the implementation of the MultipartParser class */
+
+#include <MultipartParser.hpp>
+
+const size_t MultipartParser::mMaxHeadersSize = 8192;
+
+MultipartParser::MultipartParser()
+	: mState(CONTENT)
+	, mIsWritingFile()
+	, mSyncPolicy(Config::LocationContext::SYNC_OFF)
+	, mSyncInterval()
+	, mIsDirect() {}
+
+MultipartParser::~MultipartParser() {
+
+	// a malformed or unfinished body leaves no file behind
+		// (the file of an unfinished part disappears
+		// when it's closed)
+	if (isComplete() == false) {
+
+		for (std::vector<std::string>::const_iterator file
+			= mFiles.begin(); file != mFiles.end(); ++file)
+			removeFile(*file);
+
+	}
+
+}
+
+bool MultipartParser::getBoundary(const std::string& contentType,
+	std::string& boundary, bool& isValid) {
+
+	static const std::string type = "multipart/form-data";
+
+	isValid = true;
+
+	if (contentType.size() < type.size()
+		|| isEqualNoCase(contentType.substr(0, type.size()), type) == false)
+		return false;
+
+	// 1 to 70 characters (RFC 2046)
+	if (getParameter(contentType, "boundary", boundary) == false
+		|| boundary.empty() || boundary.size() > 70)
+		isValid = false;
+
+	return true;
+
+}
+
+void MultipartParser::start(const std::string& boundary,
+	const std::string& uploadDir) {
+
+	mDelimiter = "\r\n--" + boundary;
+	mUploadDir = uploadDir;
+
+	// the body starts with a delimiter that has no CRLF
+		// so it's parsed as if it came before the body
+	mCarry = "\r\n";
+
+	const size_t delimiterSize = mDelimiter.size();
+
+	for (size_t i = 0; i < 256; ++i)
+		mShifts[i] = delimiterSize;
+
+	// the last byte keeps the shift of its other occurences
+	for (size_t i = 0; i < delimiterSize - 1; ++i)
+		mShifts[static_cast<unsigned char>(mDelimiter[i])]
+			= delimiterSize - 1 - i;
+
+}
+
+void MultipartParser::setStoreOptions(const SyncPolicy syncPolicy,
+	const Size syncInterval, const bool isDirect) {
+
+	mSyncPolicy = syncPolicy;
+	mSyncInterval = syncInterval;
+	mIsDirect = isDirect;
+
+}
+
+bool MultipartParser::write(const char* data, const size_t size) {
+
+	size_t consumed = 0;
+
+	while (consumed < size) {
+
+		size_t parsed = 0;
+
+		switch (mState) {
+			case CONTENT:
+				parsed = parseContent(data + consumed, size - consumed);
+				break;
+			case DELIMITER_END:
+				parsed = parseDelimiterEnd(data + consumed, size - consumed);
+				break;
+			case HEADERS:
+				parsed = parseHeaders(data + consumed, size - consumed);
+				break;
+			// what follows the last part is ignored
+			case EPILOGUE:
+				return true;
+		}
+
+		if (parsed == std::string::npos)
+			return false;
+
+		consumed += parsed;
+
+	}
+
+	return true;
+
+}
+
+bool MultipartParser::isComplete() const {
+	return (mState == EPILOGUE);
+}
+
+const std::vector<std::string>& MultipartParser::getFiles() const {
+	return mFiles;
+}
+
+size_t MultipartParser::parseContent(const char* data, const size_t size) {
+
+	// the bytes that can start a delimiter that isn't complete
+	const size_t keptSize = mDelimiter.size() - 1;
+
+	// a delimiter that starts in the carried bytes ends
+		// within the first keptSize bytes of data
+	if (mCarry.empty() == false) {
+
+		std::string window = mCarry;
+		window.append(data, std::min(size, keptSize));
+
+		const size_t delimiterPos =
+			findDelimiter(window.data(), window.size());
+
+		if (delimiterPos != std::string::npos) {
+
+			writeContent(window.data(), delimiterPos);
+			closePartFile();
+
+			const size_t consumed =
+				delimiterPos + mDelimiter.size() - mCarry.size();
+			mCarry.clear();
+			mState = DELIMITER_END;
+			return consumed;
+
+		}
+
+		// data is too short to tell, so it's carried
+			// along with the last carried bytes
+		if (size < keptSize) {
+
+			const size_t writtenSize = window.size() > keptSize
+				? window.size() - keptSize : 0;
+
+			writeContent(window.data(), writtenSize);
+			mCarry = window.substr(writtenSize);
+			return size;
+
+		}
+
+		writeContent(mCarry.data(), mCarry.size());
+		mCarry.clear();
+
+	}
+
+	const size_t delimiterPos = findDelimiter(data, size);
+
+	if (delimiterPos != std::string::npos) {
+
+		writeContent(data, delimiterPos);
+		closePartFile();
+		mState = DELIMITER_END;
+		return delimiterPos + mDelimiter.size();
+
+	}
+
+	// the end of data may be the start of a delimiter
+	const size_t carriedSize = std::min(size, keptSize);
+
+	writeContent(data, size - carriedSize);
+	mCarry.assign(data + size - carriedSize, carriedSize);
+
+	return size;
+
+}
+
+size_t MultipartParser::parseDelimiterEnd(const char* data,
+	const size_t size) {
+
+	const size_t parsed = std::min(size, 2 - mHeaders.size());
+
+	mHeaders.append(data, parsed);
+
+	if (mHeaders.size() < 2)
+		return parsed;
+
+	// the close delimiter
+	if (mHeaders == "--")
+		mState = EPILOGUE;
+	// the header section of the next part follows
+	else if (mHeaders == "\r\n")
+		mState = HEADERS;
+	else
+		return std::string::npos;
+
+	mHeaders.clear();
+
+	return parsed;
+
+}
+
+size_t MultipartParser::parseHeaders(const char* data, const size_t size) {
+
+	// the end of the section may be split between two
+		// slices so its search starts 3 bytes before
+	const size_t searchPos = mHeaders.size() < 3 ? 0 : mHeaders.size() - 3;
+	const size_t previousSize = mHeaders.size();
+
+	// enough to find the end of the largest section
+	mHeaders.append(data, std::min(size,
+		mMaxHeadersSize + 4 - previousSize));
+
+	// a part must have a content-disposition field
+	if (mHeaders.compare(0, 2, "\r\n") == 0)
+		return std::string::npos;
+
+	const std::string::size_type headersEnd =
+		mHeaders.find("\r\n\r\n", searchPos);
+
+	if (headersEnd == std::string::npos) {
+
+		if (mHeaders.size() > mMaxHeadersSize)
+			return std::string::npos;
+
+		return mHeaders.size() - previousSize;
+
+	}
+
+	const size_t consumed = headersEnd + 4 - previousSize;
+
+	mHeaders.resize(headersEnd);
+
+	if (openPartFile() == false)
+		return std::string::npos;
+
+	mHeaders.clear();
+	mState = CONTENT;
+
+	return consumed;
+
+}
+
+size_t MultipartParser::findDelimiter(const char* data,
+	const size_t size) const {
+
+	const size_t delimiterSize = mDelimiter.size();
+
+	if (size < delimiterSize)
+		return std::string::npos;
+
+	const char* delimiter = mDelimiter.data();
+	const unsigned char lastByte = delimiter[delimiterSize - 1];
+
+	// compares the last byte of each window first and moves
+		// the window by the shift of that byte
+	for (size_t pos = 0; pos <= size - delimiterSize; ) {
+
+		const unsigned char windowLastByte = data[pos + delimiterSize - 1];
+
+		if (windowLastByte == lastByte && std::memcmp(data + pos,
+			delimiter, delimiterSize - 1) == 0)
+			return pos;
+
+		pos += mShifts[windowLastByte];
+
+	}
+
+	return std::string::npos;
+
+}
+
+void MultipartParser::writeContent(const char* data, const size_t size) {
+
+	// the preamble and the form fields are skipped
+	if (mIsWritingFile && size)
+		mFile.write(data, size);
+
+}
+
+bool MultipartParser::openPartFile() {
+
+	std::string disposition;
+	bool isDispositionFound = false;
+
+	// finds the content-disposition field among the fields
+		// of the section which are separated by CRLFs
+	for (std::string::size_type lineStart = 0;
+		lineStart < mHeaders.size(); ) {
+
+		std::string::size_type lineEnd = mHeaders.find("\r\n", lineStart);
+		if (lineEnd == std::string::npos)
+			lineEnd = mHeaders.size();
+
+		const std::string line =
+			mHeaders.substr(lineStart, lineEnd - lineStart);
+		const std::string::size_type colonPos = line.find(':');
+
+		if (colonPos != std::string::npos && isEqualNoCase(
+			trimWhiteSpace(line.substr(0, colonPos)), "content-disposition")) {
+			disposition = trimWhiteSpace(line.substr(colonPos + 1));
+			isDispositionFound = true;
+		}
+
+		lineStart = lineEnd + 2;
+
+	}
+
+	if (isDispositionFound == false)
+		return false;
+
+	std::string fileName;
+
+	// a form field or a file input where no file was selected
+	if (getParameter(disposition, "filename", fileName) == false
+		|| fileName.empty())
+		return true;
+
+	mPartName = sanitizeFileName(fileName);
+
+	mFile.create(mUploadDir, mIsDirect);
+	mFile.setSync(mSyncPolicy, mSyncInterval);
+
+	mIsWritingFile = true;
+
+	return true;
+
+}
+
+void MultipartParser::closePartFile() {
+
+	if (mIsWritingFile == false)
+		return ;
+
+	mIsWritingFile = false;
+
+	mFile.finish();
+
+	// an existing file isn't replaced (even one that was created
+		// while the part was written) and a name that can't be
+		// used is replaced
+	std::string path = mUploadDir + '/' + mPartName;
+
+	if (mPartName.empty() || mFile.commit(path) == false) {
+
+		path = generateFileName(mUploadDir);
+
+		if (mPartName.empty() == false)
+			path += '_' + mPartName;
+
+		if (mFile.commit(path) == false)
+			throw std::runtime_error("MultipartParser::closePartFile(): '"
+				+ path + "' already exists");
+
+	}
+
+	mFiles.push_back(path);
+
+	mFile.close();
+
+}
+
+std::string MultipartParser::sanitizeFileName(const std::string& fileName) {
+
+	// some clients send the full path of the file
+	const std::string::size_type separatorPos =
+		fileName.find_last_of("/\\");
+
+	std::string name = separatorPos == std::string::npos
+		? fileName : fileName.substr(separatorPos + 1);
+
+	for (std::string::size_type i = 0; i < name.size(); ++i) {
+
+		const unsigned char character = name[i];
+
+		if (character < 0x20 || character == 0x7F)
+			return "";
+
+	}
+
+	if (name == "." || name == ".." || name.size() > 200)
+		return "";
+
+	return name;
+
+}
+
+bool MultipartParser::getParameter(const std::string& value,
+	const std::string& name, std::string& parameter) {
+
+	// the parameters follow the first ';'
+	std::string::size_type pos = value.find(';');
+
+	while (pos != std::string::npos) {
+
+		const std::string::size_type equalPos = value.find('=', pos + 1);
+		if (equalPos == std::string::npos)
+			return false;
+
+		const std::string parameterName =
+			trimWhiteSpace(value.substr(pos + 1, equalPos - pos - 1));
+
+		std::string parameterValue;
+
+		pos = value.find_first_not_of(" \t", equalPos + 1);
+
+		// a quoted value may contain ';'
+		if (pos != std::string::npos && value[pos] == '"') {
+
+			const std::string::size_type quotePos = value.find('"', pos + 1);
+			if (quotePos == std::string::npos)
+				return false;
+
+			parameterValue = value.substr(pos + 1, quotePos - pos - 1);
+			pos = value.find(';', quotePos);
+
+		}
+		else if (pos != std::string::npos) {
+
+			const std::string::size_type endPos = value.find(';', pos);
+			parameterValue = trimWhiteSpace(value.substr(pos,
+				endPos == std::string::npos ? endPos : endPos - pos));
+			pos = endPos;
+
+		}
+
+		if (isEqualNoCase(parameterName, name)) {
+			parameter = parameterValue;
+			return true;
+		}
+
+	}
+
+	return false;
+
+}
@@ -0,0 +1,172 @@
+/* this file contains the definition of the MultipartParser class
+ * It parses a multipart/form-data body as it's received and writes
+ *  the content of each file part straight to its own file in the
+ *  upload directory (named after the filename of the part), so the
+ *  raw body is never stored. Each file only appears in the directory
+ *  once its part is complete (see FileWriter). The parts that aren't files (form
+ *  fields) are skipped.
+ * The body is fed in slices with write(). The delimiters (CRLF--
+ *  followed by the boundary) are found with a Boyer-Moore-Horspool
+ *  search over the new bytes only: at most the last delimiter length
+ *  - 1 bytes of a slice are carried to the next one in case they are
+ *  the start of a delimiter that is split between the two slices.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+#include <FileWriter.hpp>
+#include <utils.hpp>
+
+class MultipartParser {
+
+	public:
+		/******* alias types *******/
+		typedef FileWriter::SyncPolicy SyncPolicy;
+		typedef FileWriter::Size Size;
+
+		/******* public member functions *******/
+		MultipartParser();
+
+		// removes the written files if the body
+			// wasn't fully parsed
+		~MultipartParser();
+
+		// extracts the boundary from the value of a content-type
+			// header (multipart/form-data; boundary=...)
+		// returns false if it isn't a multipart/form-data type
+		// sets isValid to false if it is one but has no
+			// valid boundary
+		static bool getBoundary(const std::string& contentType,
+			std::string& boundary, bool& isValid);
+
+		// prepares the parsing of a body whose parts are separated
+			// by boundary and whose files go to uploadDir
+		void start(const std::string& boundary,
+			const std::string& uploadDir);
+
+		// sets how the files are written (see FileWriter)
+		void setStoreOptions(const SyncPolicy syncPolicy,
+			const Size syncInterval, const bool isDirect);
+
+		// parses the next size bytes of data of the body
+		// returns false if the body is malformed
+		// throws std::runtime_error if a file couldn't be written
+		bool write(const char* data, const size_t size);
+
+		// returns false if the body ended before
+			// its close delimiter
+		bool isComplete() const;
+
+		// returns the paths of the written files
+		const std::vector<std::string>& getFiles() const;
+
+	private:
+		/******* private nested types *******/
+		// part of the body that's being parsed
+		enum State {
+			// the content of a part (or the preamble
+				// before the first delimiter)
+			CONTENT,
+			// the two bytes that follow a delimiter
+				// (CRLF or -- for the close delimiter)
+			DELIMITER_END,
+			// the header fields of a part
+			HEADERS,
+			// everything after the close delimiter
+			EPILOGUE
+		};
+
+		/******* private member objects *******/
+		State mState;
+
+		// CRLF--boundary
+		std::string mDelimiter;
+
+		// number of positions by which the search moves for
+			// each byte value (Horspool's bad character table)
+		size_t mShifts[256];
+
+		// last bytes of the previous slice that may
+			// be the start of a delimiter
+		std::string mCarry;
+
+		// bytes of the header section (or the delimiter end)
+			// that were received so far
+		std::string mHeaders;
+
+		std::string mUploadDir;
+
+		// writes the file of the current part
+		FileWriter mFile;
+
+		// set if the current part is a file
+			// that's written to mFile
+		bool mIsWritingFile;
+
+		// name under which the file of the current part is
+			// saved (empty if it gets a generated one)
+		std::string mPartName;
+
+		std::vector<std::string> mFiles;
+
+		SyncPolicy mSyncPolicy;
+		Size mSyncInterval;
+		bool mIsDirect;
+
+		// size that the header section of a part can't exceed
+		static const size_t mMaxHeadersSize;
+
+		/******* private member functions *******/
+		// parses the content of a part from data and returns
+			// the number of consumed bytes
+		size_t parseContent(const char* data, const size_t size);
+
+		// parses the bytes after a delimiter and returns the
+			// number of consumed bytes or std::string::npos
+			// if they are invalid
+		size_t parseDelimiterEnd(const char* data, const size_t size);
+
+		// parses the header section of a part and returns the
+			// number of consumed bytes or std::string::npos
+			// if it's invalid
+		size_t parseHeaders(const char* data, const size_t size);
+
+		// returns the position of mDelimiter in data or
+			// std::string::npos if it's not there
+		size_t findDelimiter(const char* data, const size_t size) const;
+
+		// appends content to the file of the current part if any
+		void writeContent(const char* data, const size_t size);
+
+		// creates the file of a part whose header section
+			// is mHeaders if it's a file part
+		// returns false if its headers are invalid
+		bool openPartFile();
+
+		// finishes the file of the current part and
+			// commits it to the upload directory
+		// throws std::runtime_error on error
+		void closePartFile();
+
+		// returns the name under which the file whose name was sent
+			// by the client is saved (without its directories)
+			// or an empty string if it can't be used
+		static std::string sanitizeFileName(const std::string& fileName);
+
+		// returns the value of the parameter name within a
+			// header value (like filename in form-data;
+			// name="file"; filename="a.txt")
+		// returns false if it's not found
+		static bool getParameter(const std::string& value,
+			const std::string& name, std::string& parameter);
+
+		MultipartParser(const MultipartParser&);
+
+		MultipartParser& operator=(const MultipartParser&);
+
+};
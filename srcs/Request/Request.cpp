@@ -5,6 +5,7 @@
 size_t Request::mReadSize = 1024;
 size_t Request::mRequestLineSizeLimit = 2048;
 size_t Request::mHeadersSizeLimit = 8192;
+const std::string Request::mContinueResponse = "HTTP/1.1 100 Continue\r\n\r\n";
 
 std::map<std::string, Request::Method>
 	Request::mSupportedMethods;
@@ -18,11 +19,16 @@ Request::Request(Socket socket, ConstServerRef server)
 	, mLastBuffSize()
 	, mHeaders(mBuffer)
 	, mURL(mServer)
+	, mRoute()
+	, mIsRouteCached()
+	, mAsset()
 	, mStatusCode(StatusCodeHandler::OK)
 	, mRequestType(UNDETERMINED)
 	, mRequestChecker(*this)
 	, mSocketOk(true)
-	, mRequestBody(mBuffer, mServer.clientBodySizeMax) {}
+	, mContinueWritten(-1)
+	, mRequestBody(mBuffer, mServer.clientBodySizeMax,
+		mServer.clientBodyBufferSize) {}
 
 Request::Request(const Request& request)
 	: mSocket(request.mSocket)
@@ -33,11 +39,16 @@ Request::Request(const Request& request)
 	, mLastBuffSize()
 	, mHeaders(mBuffer)
 	, mURL(mServer)
+	, mRoute()
+	, mIsRouteCached()
+	, mAsset()
 	, mStatusCode(StatusCodeHandler::OK)
 	, mRequestType(UNDETERMINED)
 	, mRequestChecker(*this)
 	, mSocketOk(true)
-	, mRequestBody(mBuffer, mServer.clientBodySizeMax) {}
+	, mContinueWritten(-1)
+	, mRequestBody(mBuffer, mServer.clientBodySizeMax,
+		mServer.clientBodyBufferSize) {}
 
 void Request::initializeStaticData() {
 	setSupportedMethods();
@@ -47,6 +58,10 @@ bool Request::isRead() const {
 	return (mStage != FINISH);
 }
 
+bool Request::isWrite() const {
+	return (mContinueWritten != -1);
+}
+
 bool Request::isValid() const {
 
 	if (mStage != FINISH) {
@@ -100,6 +115,26 @@ const std::string& Request::getFullPath() const {
 	return mURL.getFullPath();
 }
 
+Request::ConstServerRef Request::getServer() const {
+	return mServer;
+}
+
+const Request::Route* Request::getCachedRoute() const {
+	return (mIsRouteCached ? &mRoute : NULL);
+}
+
+const FileInfo& Request::getFileInfo() const {
+	return mFileInfo;
+}
+
+FileInfo& Request::getFileInfo() {
+	return mFileInfo;
+}
+
+const AssetPack::Entry& Request::getAsset() const {
+	return mAsset;
+}
+
 const Request::StatusCodeType&
 	Request::getStatusCode() const {
 
@@ -121,6 +156,26 @@ const std::string&
 
 }
 
+const TempFile& Request::getBodyFile() const {
+	return mBodyTempFile;
+}
+
+bool Request::isBodyInMemory() const {
+	return mRequestBody.isInMemory();
+}
+
+const std::string& Request::getBodyBuffer() const {
+	return mRequestBody.getMemoryBody();
+}
+
+const std::vector<std::string>& Request::getUploadedFiles() const {
+	return mMultipartParser.getFiles();
+}
+
+const ResumableUpload& Request::getResumableUpload() const {
+	return mResumableUpload;
+}
+
 void Request::setStatusCode
 	(const StatusCodeType& code) {
 
@@ -135,6 +190,10 @@ void Request::setRequestType
 
 }
 
+void Request::setAsset(const AssetPack::Entry& asset) {
+	mAsset = asset;
+}
+
 void Request::proceedWithSocket() {
 
 	// throws an error if the 
@@ -146,6 +205,16 @@ void Request::proceedWithSocket() {
 		throw std::runtime_error(errorMsg);
 	}
 
+	// the client waits for it to send the body
+	if (isWrite())
+		return writeContinue();
+
+	// the rest of a large upload body is moved from the
+		// socket to its file without going through mBuffer
+	if (mStage == BODY && mBuffer.empty()
+		&& mRequestBody.isSpliceable())
+		return spliceBody();
+
 	// buffer on which read data
 		// will be stored
 	char readBuffer[mReadSize];
@@ -154,6 +223,11 @@ void Request::proceedWithSocket() {
 	ssize_t readAmount =
 		read(mSocket, readBuffer, mReadSize);
 
+	// nothing to read yet, it's tried again
+		// once the socket is readable
+	if (readAmount == -1 && isRetryError())
+		return ;
+
 	// failed to read from socket
 	if (readAmount < 1) {
 		mSocketOk = false;
@@ -298,9 +372,10 @@ void Request::determineRequestType() {
 		return ;
 	}
 
-	// if the request method is not post or the request type
-		// is not an upload or cgi, then request body isn't needed
-	if (mMethod != POST || (mRequestType != UPLOAD
+	// if the request method is not post (or put) or the request
+		// type is not an upload or cgi, then request body
+		// isn't needed
+	if ((mMethod != POST && mMethod != PUT) || (mRequestType != UPLOAD
 		&& mRequestType != CGI)) {
 		mStage = FINISH;
 		return;
@@ -325,6 +400,11 @@ void Request::determineRequestType() {
 		return moveFinStage(mRequestBody.getStatusCode());
 	}
 
+	// the request is valid so the client that waits
+		// before sending the body can send it
+	if (setExpectation() == false)
+		return ;
+
 	// moves to the body parsing stage
 	mStage = BODY;
 
@@ -334,28 +414,52 @@ void Request::determineRequestType() {
 
 bool Request::setBodyParsingInfo() {
 
+	// a PUT upload may only ask for its state without
+		// a body, so it checks the length of the body itself
+	if (mMethod == PUT && mRequestType == UPLOAD)
+		return setResumableUploadInfo();
+
 	// size of body is dealt with first
 	// checks if the length of the body is valid
 	if (setBodyLengthInfo() == false)
 		return false;
 
-	// the directory where the body
-		// will be stored
-	// if it's an upload request, the body
-		// will be stored in the specified
-		// upload directory of the configured
-		// location
-	// otherwise a generic directory for
-		// storing temporary files is used
-	const std::string& bodyStoreFileDir
-		= (mRequestType ==  UPLOAD) ?
-		mLocation->uploadRoute :
-		ServerManager::getTmpFilesDir();
+	// the body of a CGI request is only passed to the
+		// script so it's kept in memory or in an
+		// anonymous file if it's large
+	if (mRequestType == CGI) {
+		mRequestBody.setBodyStore(mBodyTempFile);
+		return true;
+	}
+
+	// the files of a multipart/form-data body are
+		// written to the upload directory as they're parsed
+	const HeaderValue* contentType = getHeaderValue("content-type");
+	std::string boundary;
+	bool isBoundaryValid = false;
+
+	if (contentType && MultipartParser::getBoundary(*contentType,
+		boundary, isBoundaryValid)) {
+
+		if (isBoundaryValid == false) {
+			moveFinStage(StatusCodeHandler::BAD_REQUEST);
+			return false;
+		}
+
+		mMultipartParser.start(boundary, mLocation->uploadRoute);
+		mMultipartParser.setStoreOptions(mLocation->uploadSync,
+			mLocation->uploadSyncInterval, mLocation->uploadDirect);
+		mRequestBody.setBodyStore(mMultipartParser);
+		return true;
+
+	}
 
+	// the body of an upload request is stored in
+		// the upload directory of the configured location
 	// generates a unique filename prefixed
-		// with the set directory
+		// with that directory
 	try {
-		mBodyFileName = generateFileName(bodyStoreFileDir);	
+		mBodyFileName = generateFileName(mLocation->uploadRoute);
 	}
 	catch (const std::exception& e) {
 		moveFinStage(StatusCodeHandler::SERVER_ERROR);
@@ -364,6 +468,8 @@ bool Request::setBodyParsingInfo() {
 
 	// passes the filename where the body should be stored
 	mRequestBody.setBodyStore(mBodyFileName);
+	mRequestBody.setStoreOptions(mLocation->uploadSync,
+		mLocation->uploadSyncInterval, mLocation->uploadDirect);
 
 	return true;
 
@@ -400,6 +506,86 @@ bool Request::setBodyLengthInfo() {
 
 }
 
+bool Request::setResumableUploadInfo() {
+
+	// the body is written at the range of the file it
+		// covers so its length must be known, which is
+		// only checked by mResumableUpload when there's
+		// no Content-Length since a request that asks
+		// for the state of the upload has no body
+	const HeaderValue* contentLength = getHeaderValue("content-length");
+	RequestBody::Size length = 0;
+
+	if (contentLength) {
+
+		if (setBodyLengthInfo() == false)
+			return false;
+
+		// the invalid length is reported by the caller
+		if (mRequestBody.isValid() == false)
+			return true;
+
+		length = strToNum<RequestBody::Size>(*contentLength);
+
+	}
+	else if (getHeaderValue("transfer-encoding")) {
+		moveFinStage(StatusCodeHandler::LEN_REQUIRED);
+		return false;
+	}
+
+	// the file is named by the part of the path that
+		// follows the location route, so a request to
+		// the location itself has no file to upload
+	if (getPath().size() <= mLocation->route.size()) {
+		moveFinStage(StatusCodeHandler::BAD_REQUEST);
+		return false;
+	}
+
+	std::string name(getPath(), mLocation->route.size());
+	if (name.empty() == false && name[0] == '/')
+		name.erase(0, 1);
+
+	const StatusCodeType status = mResumableUpload.start(
+		mLocation->uploadRoute, name,
+		getHeaderValue("content-range"),
+		contentLength ? &length : NULL);
+
+	// the request only asked for the state of the upload
+		// or its range can't be written
+	if (status != StatusCodeHandler::OK) {
+		moveFinStage(status);
+		return false;
+	}
+
+	// the range may start anywhere so O_DIRECT isn't used
+	mRequestBody.setBodyStore(mResumableUpload.getPartPath(),
+		mResumableUpload.getStart());
+	mRequestBody.setStoreOptions(mLocation->uploadSync,
+		mLocation->uploadSyncInterval, false);
+
+	return true;
+
+}
+
+void Request::finishBody() {
+
+	mStage = FINISH;
+	// the body was complete without it (it was empty)
+	mContinueWritten = -1;
+
+	if (mMethod != PUT || mRequestBody.isValid() == false)
+		return ;
+
+	try {
+		mStatusCode = mResumableUpload.finish();
+	}
+	catch (const std::exception& e) {
+		Log::error(e.what());
+		mStatusCode = StatusCodeHandler::SERVER_ERROR;
+	}
+
+}
+
 void Request::parseBody() {
 
 	try {
@@ -420,7 +606,7 @@ void Request::parseBody() {
 
 		// whole body was received
 		if (mRequestBody.isDone()) {
-			mStage = FINISH;
+			finishBody();
 		}
 
 	}
@@ -432,6 +618,36 @@ void Request::parseBody() {
 
 }
 
+void Request::spliceBody() {
+
+	try {
+
+		const ssize_t movedAmount = mRequestBody.spliceFrom(mSocket);
+
+		// nothing to read yet, it's tried again
+			// once the socket is readable
+		if (movedAmount == -1 && isRetryError())
+			return ;
+
+		// failed to read from socket
+		if (movedAmount < 1) {
+			mSocketOk = false;
+			mStage = FINISH;
+			Log::socketFailed(mSocket, "splice", movedAmount);
+			return ;
+		}
+
+		if (mRequestBody.isDone())
+			finishBody();
+
+	}
+	catch (const std::exception& e) {
+		Log::error(e.what());
+		moveFinStage(mRequestBody.getStatusCode());
+	}
+
+}
+
 bool Request::parseMethod
 	(const std::string::size_type endOfLinePos) {
 	
@@ -498,8 +714,31 @@ bool Request::parseURL() {
 	// get the url substring from mBuffer
 	const std::string url = mBuffer.substr
 		(urlStartPos, urlEndPos - urlStartPos);
-	mURL.parse(url);
 
+	// the path may have been routed by a previous request
+		// (the routes are keyed by the normalized path
+		// so that the spellings of a path share one)
+	std::string path;
+	const bool isNormalized = URL::normalizePath
+		(url.substr(0, url.find('?')), path);
+	mIsRouteCached = isNormalized
+		&& RouteCache::find(mServer, mMethod, path, mRoute);
+
+	if (mIsRouteCached)
+		mURL.parse(url, mRoute.location, mRoute.fullPath);
+	else
+		mURL.parse(url);
+
+	// a path that matches no location is remembered as well
+	if (isNormalized && mIsRouteCached == false
+		&& mURL.isValid() == false
+		&& mURL.getStatusCode() == StatusCodeHandler::NOT_FOUND) {
+
+		Route route = Route();
+		route.statusCode = StatusCodeHandler::NOT_FOUND;
+		RouteCache::store(mServer, mMethod, path, route);
+
+	}
 
 	// if url is invalid move to finish stage
 		// with the appropriate error status code
@@ -519,11 +758,62 @@ bool Request::parseURL() {
 
 }
 
+bool Request::setExpectation() {
+
+	const HeaderValue* expect = getHeaderValue("expect");
+
+	if (expect == NULL)
+		return true;
+
+	if (isEqualNoCase(trimWhiteSpace(*expect), "100-continue") == false) {
+		moveFinStage(StatusCodeHandler::EXPECTATION_FAILED);
+		return false;
+	}
+
+	// the client that already started sending
+		// the body doesn't wait anymore
+	if (mBuffer.empty())
+		mContinueWritten = 0;
+
+	return true;
+
+}
+
+void Request::writeContinue() {
+
+	const ssize_t writtenBytes = write(mSocket,
+		mContinueResponse.data() + mContinueWritten,
+		mContinueResponse.size() - mContinueWritten);
+
+	// the socket buffer is full so the rest is
+		// written on the next writable event
+	if (writtenBytes == -1 && isRetryError())
+		return ;
+
+	if (writtenBytes < 1) {
+		mContinueWritten = -1;
+		mSocketOk = false;
+		mStage = FINISH;
+		Log::socketFailed(mSocket, "write", writtenBytes);
+		return ;
+	}
+
+	mContinueWritten += writtenBytes;
+
+	// the body can be read
+	if (static_cast<size_t>(mContinueWritten)
+		== mContinueResponse.size())
+		mContinueWritten = -1;
+
+}
+
 void Request::moveFinStage
 	(const StatusCodeType code) {
 
 	mStage = FINISH;
 	mStatusCode = code;
+	// the body won't be read
+	mContinueWritten = -1;
 
 }
 
@@ -553,6 +843,7 @@ void Request::setSupportedMethods() {
 	mSupportedMethods["GET"] = GET;
 	mSupportedMethods["POST"] = POST;
 	mSupportedMethods["DELETE"] = DELETE;
+	mSupportedMethods["PUT"] = PUT;
 
 }
 
@@ -570,6 +861,8 @@ void Request::print() const {
 			std::cout << "POST" << '\n'; break;
 		case DELETE:
 			std::cout << "DELETE" << '\n'; break;
+		case PUT:
+			std::cout << "PUT" << '\n'; break;
 		default: 
 			std::cout << "UNSPECIFIED" << '\n';
 	}
@@ -596,6 +889,8 @@ void Request::print() const {
 			std::cout << "default file" << '\n'; break;
 		case CONTENT:
 			std::cout << "static file" << '\n'; break;
+		case ASSET:
+			std::cout << "asset pack file" << '\n'; break;
 		default: 
 			std::cout << "undetermined" << '\n';
 	}
@@ -21,6 +21,10 @@
 #include <Log.hpp>
 #include <RequestChecker.hpp>
 #include <RequestBody.hpp>
+#include <FileInfo.hpp>
+#include <AssetPack.hpp>
+#include <TempFile.hpp>
+#include <ResumableUpload.hpp>
 
 class Request {
 
@@ -31,6 +35,7 @@ class Request {
 			GET,
 			POST,
 			DELETE,
+			PUT,
 			UNSPECIFIED
 		};
 
@@ -51,7 +56,9 @@ class Request {
 			CGI,
 			UPLOAD,
 			DEFAULT,
-			CONTENT
+			CONTENT,
+			// a file of the location's asset pack
+			ASSET
 		};
 
 		/******* alias types *******/
@@ -62,6 +69,23 @@ class Request {
 		typedef RequestHeaders::HeaderName HeaderName;
 		typedef RequestHeaders::HeaderValue HeaderValue;
 
+		/******* nested types *******/
+		// result of the routing and classification of a
+			// (method, path) pair which is kept in RouteCache
+			// so that it's reused by the next requests
+		struct Route {
+			// NULL if the path matches no location
+			ConstLocPtr location;
+			std::string fullPath;
+			RequestType requestType;
+			StatusCodeType statusCode;
+			// value returned by RequestChecker::isValid()
+			bool isValid;
+			// state of the full path when it was classified
+			bool isPath;
+			bool isDir;
+		};
+
 		/******* public member functions *******/
 		// first parameter is the socket from which
 			// the request is received
@@ -80,9 +104,16 @@ class Request {
 			// object ready for further processing
 		bool isRead() const ;
 
+		// returns true if it wants to write the interim
+			// "100 Continue" response to the socket before
+			// the body is read (see proceedWithSocket())
+		bool isWrite() const;
+
 		// signals that the socket is ready for reading
 			// attempts to read from socket
 			// and parse request bytes
+		// writes the interim response instead
+			// if isWrite() is true
 		// if it's called and Request is done reading,
 			// throws std:runtime_error
 		void proceedWithSocket();
@@ -125,15 +156,54 @@ class Request {
 		// returns full path of the requested path
 		const std::string& getFullPath() const;
 
+		// returns the server on which the request arrives
+		ConstServerRef getServer() const;
+
+		// returns the route of the request if it was found in
+			// RouteCache, otherwise NULL
+		const Route* getCachedRoute() const;
+
+		// returns the descriptor and metadata of the
+			// full path (resolved by RequestChecker)
+		const FileInfo& getFileInfo() const;
+
+		FileInfo& getFileInfo();
+
+		// returns the file of the asset pack that's
+			// served by an ASSET request
+		const AssetPack::Entry& getAsset() const;
+
 		const StatusCodeType& getStatusCode() const;
 
 		// returns the type of the parsed Request
 		const RequestType& getRequestType() const;
 
 		// returns the path where the request body is stored
-		// if there is no body, it returns an empty path
+		// if there is no body or it's stored in an
+			// anonymous file, it returns an empty path
 		const std::string& getPathToBodyFileName() const;
 
+		// returns the anonymous file where the body of
+			// a CGI request is stored if it's not in memory
+		const TempFile& getBodyFile() const;
+
+		// returns true if the body of a CGI request is
+			// small enough to be kept in memory
+			// (see getBodyBuffer())
+		bool isBodyInMemory() const;
+
+		// returns the body of a CGI request
+			// if isBodyInMemory() is true
+		const std::string& getBodyBuffer() const;
+
+		// returns the paths of the files written from a
+			// multipart upload (getPathToBodyFileName()
+			// is empty for such an upload)
+		const std::vector<std::string>& getUploadedFiles() const;
+
+		// returns the state of the upload of a PUT request
+		const ResumableUpload& getResumableUpload() const;
+
 		/******* setters *******/
 		// sets the mStatusCode
 		void setStatusCode(const StatusCodeType& code);
@@ -141,6 +211,9 @@ class Request {
 		// sets the RequestType
 		void setRequestType(const RequestType& requestType);
 
+		// sets the file of the asset pack to be served
+		void setAsset(const AssetPack::Entry& asset);
+
 	private:
 		/******* private member objects *******/
 		// socket from which the
@@ -182,6 +255,20 @@ class Request {
 			// context of the path)
 		URL mURL;
 
+		// route found in RouteCache for the method
+			// and path (if mIsRouteCached is set)
+		Route mRoute;
+
+		bool mIsRouteCached;
+
+		// the full path opened once by RequestChecker
+			// and served from by Response
+		FileInfo mFileInfo;
+
+		// file found in the asset pack of the
+			// location (ASSET requests only)
+		AssetPack::Entry mAsset;
+
 		// it is initialized at first to OK, but changed
 			// on error or redirection
 		StatusCodeType mStatusCode;
@@ -194,17 +281,37 @@ class Request {
 		// changed to false if cannot read from socket
 		bool mSocketOk;
 
+		// number of bytes of mContinueResponse that were
+			// written if the client waits for it before
+			// sending the body (-1 if it doesn't)
+		ssize_t mContinueWritten;
+
 		// used to parse the request body
 		RequestBody mRequestBody;
 
 		// the path to the parsed request
-			// body if there is one
+			// body of an upload
 		std::string mBodyFileName;
 
+		// the parsed request body of a CGI
+			// request which has no name
+		// only created if the body doesn't fit
+			// in memory
+		TempFile mBodyTempFile;
+
+		// parses the body of a multipart/form-data
+			// upload request
+		MultipartParser mMultipartParser;
+
+		// the file uploaded (in pieces) by a PUT request
+		ResumableUpload mResumableUpload;
+
 		// amount by which to read from socket
 		static size_t mReadSize;
 		// maximum size a request line can be
 		static size_t mRequestLineSizeLimit;
+		// interim response to an "Expect: 100-continue"
+		static const std::string mContinueResponse;
 		// mazimum size of the headers
 		static size_t mHeadersSizeLimit;
 
@@ -250,6 +357,13 @@ class Request {
 			// read from the buffer
 		void parseBody();
 
+		// moves the next bytes of the body from the
+			// socket to its store without reading them
+			// when the body is spliceable (see RequestBody)
+		// moves to the finish stage on error or when
+			// the whole body is received
+		void spliceBody();
+
 		// returns true and sets the request method if found,
 			// otherwise it's left unchanged
 		// the search for the method doesn't go further
@@ -290,11 +404,28 @@ class Request {
 		// returns false on non-exceptional errors
 		bool setBodyLengthInfo();
 
-		// creates a path where the request body will be stored
-		// the path is created depending on the type of request
-		// for example: upload requests will have different
-			// file paths than CGI
-		void createBodyFileNamePath();
+		// sets the part file of a PUT upload where the body is
+			// written or moves to the finish stage if the
+			// request has no body to write (see ResumableUpload)
+		// returns false if the body isn't read
+		bool setResumableUploadInfo();
+
+		// completes what the body was read for once it's
+			// received (commits a PUT upload)
+		void finishBody();
+
+
+		// checks the expect header of a request whose body is
+			// about to be read: a client that sends
+			// "100-continue" waits for the interim response
+			// which is then due before the body is read
+		// moves to the finish stage and returns false if
+			// the expectation isn't supported
+		bool setExpectation();
+
+		// writes the next bytes of mContinueResponse
+		// moves to the finish stage if the socket fails
+		void writeContinue();
 
 		// moves to the finish stage and
 			// sets the status code
@@ -313,3 +444,5 @@ class Request {
 // in turn cannot be included above directly because it relies on the full definition
 // of the Request class
 #include <ClientHandler.hpp>
+// relies on the full definition of the Request class as well
+#include <RouteCache.hpp>
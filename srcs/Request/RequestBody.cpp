@@ -2,15 +2,75 @@
 
 #include <RequestBody.hpp>
 
+const size_t RequestBody::mSpliceSize = 1024 * 1024;
+
+const size_t RequestBody::mMaxChunkLineSize = 8192;
+
+const signed char RequestBody::mHexValues[256] = {
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+	-1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
 RequestBody::RequestBody(const std::string& buffer,
-	const Size maxBodySize)
+	const Size maxBodySize, const Size memoryLimit)
 	: mBuffer(buffer)
 	, mMaxBodySize(maxBodySize)
+	, mMemoryLimit(memoryLimit)
+	, mSyncPolicy(Config::LocationContext::SYNC_OFF)
+	, mSyncInterval()
+	, mIsDirect()
+	, mIsInPlace()
+	, mStoreOffset()
+	, mBodyFile()
+	, mMultipart()
+	, mIsStoreOpen()
 	, mDone()
 	, mContentLength()
 	, mStatusCode(StatusCodeHandler::OK)
 	, mTotalReadBytes()
-	, mChunkSize(-1) {}
+	, mSplicePipeSize(mSpliceSize)
+	, mChunkState(CHUNK_SIZE)
+	, mChunkSize()
+	, mChunkLineSize() {
+
+	mSplicePipe[0] = -1;
+	mSplicePipe[1] = -1;
+
+}
+
+RequestBody::~RequestBody() {
+
+	BufferPool::release(mMemoryBody);
+
+	// the bytes of an interrupted body that's written in
+		// place are kept so that it can be resumed from them
+	if (mIsInPlace && mIsStoreOpen && mDone == false) {
+		try {
+			mBodyStore.flush();
+		}
+		catch (const std::exception& error) {}
+	}
+
+	if (mSplicePipe[0] != -1) {
+		close(mSplicePipe[0]);
+		close(mSplicePipe[1]);
+	}
+
+}
 
 bool RequestBody::isDone() {
 	return mDone;
@@ -20,6 +80,10 @@ bool RequestBody::isValid() {
 	return (mStatusCode == StatusCodeHandler::OK);
 }
 
+bool RequestBody::isInMemory() const {
+	return (mIsStoreOpen == false && mMultipart == NULL);
+}
+
 std::string::size_type
 	RequestBody::parse() {
 	
@@ -43,22 +107,32 @@ void RequestBody::setBodyType(const BodyType type) {
 
 void RequestBody::setBodyStore
 	(const std::string& filePath) {
-	
-	// opens file in binary mode and clears its content
-	mBodyStore.open(filePath.c_str(), std::ofstream::out
-		| std::ofstream::binary | std::ofstream::trunc);
+	mBodyStorePath = filePath;
+}
 
-	// file couldn't be opened
-	if (!mBodyStore) {
+void RequestBody::setBodyStore(const std::string& filePath,
+	const Size offset) {
 
-		mStatusCode = StatusCodeHandler::SERVER_ERROR;
+	mBodyStorePath = filePath;
+	mIsInPlace = true;
+	mStoreOffset = offset;
 
-		const std::string errorMsg =
-			std::string("setBodyStore(): couldn't open file: '")
-			+ filePath + '\'';
-		throw std::runtime_error(errorMsg);
+}
 
-	}
+void RequestBody::setBodyStore(TempFile& file) {
+	mBodyFile = &file;
+}
+
+void RequestBody::setBodyStore(MultipartParser& parser) {
+	mMultipart = &parser;
+}
+
+void RequestBody::setStoreOptions(const SyncPolicy syncPolicy,
+	const Size syncInterval, const bool isDirect) {
+
+	mSyncPolicy = syncPolicy;
+	mSyncInterval = syncInterval;
+	mIsDirect = isDirect;
 
 }
 
@@ -89,6 +163,10 @@ RequestBody::StatusCodeType
 
 }
 
+const std::string& RequestBody::getMemoryBody() const {
+	return mMemoryBody;
+}
+
 std::string::size_type
 	RequestBody::parseFullLengthBody() {
 	
@@ -106,11 +184,11 @@ std::string::size_type
 
 	try {
 		// appends the read bytes to the stored request body
-		writeToStream(mBodyStore, mBuffer.c_str(), readBytes);
+		storeBody(mBuffer.c_str(), readBytes);
 	}
 	catch (const std::exception& error) {
 		// sets the appropriate status code and rethrows
-		setError(StatusCodeHandler::SERVER_ERROR);
+		setStoreError();
 		throw ;
 	}
 
@@ -121,7 +199,7 @@ std::string::size_type
 	if (mContentLength == mTotalReadBytes) {
 		mDone = true;
 		// flushing the stream after reading everything
-		mBodyStore << std::flush;
+		flushBody();
 	}
 
 	return readBytes;
@@ -135,188 +213,516 @@ void RequestBody::setError(StatusCodeType code) {
 
 }
 
-std::string::size_type 
-	RequestBody::parseChunkedBody() {
+void RequestBody::setStoreError() {
 
-	// stores the bytes consumed from mBuffer
-	std::string::size_type readBytes = 0;
+	if (isValid())
+		setError(StatusCodeHandler::SERVER_ERROR);
 
-	// keeps pasing mBuffer until no more
-		// data is availble or an error occurs
-	while (readBytes != mBuffer.size()) {
-
-		// if the chunk size is not set 
-			// extract the chunk size 
-			// from the chunk size line
-		if (mChunkSize == -1) {
-			// on error or chunk size not found
-			// if the last chunk size found (==0)
-				// sets mDone and stops
-			if (parseChunkSize(readBytes) == false)
-				break;
-		}
+	mDone = true;
+
+}
+
+void RequestBody::storeBody(const char* data, const size_t size) {
 
-		if (parseChunkData(readBytes) == true) {
-			// the whole chunk data is parsed
-				// checks the chunk separator
-			if (parseChunkSeparator(readBytes) == false)
-				break;
+	if (size == 0)
+		return ;
+
+	// the parts of a multipart body are written
+		// as they are parsed
+	if (mMultipart) {
+
+		if (mMultipart->write(data, size) == false) {
+			mStatusCode = StatusCodeHandler::BAD_REQUEST;
+			throw std::runtime_error("storeBody(): "
+				"malformed multipart body");
 		}
-	
+
+		return ;
+
 	}
 
-	// add the consumed bytes to the total
-		// bytes consumed from the body
-	mTotalReadBytes += readBytes;
+	// a body whose length is known to be too large
+		// for the memory goes to the store directly
+	const bool isFitting = mMemoryBody.size() + size <= mMemoryLimit
+		&& (mBodyType != CONTENT_LENGTH || mContentLength <= mMemoryLimit);
 
-	// returns the consumed bytes after each call
-	return readBytes;
+	if (mIsStoreOpen == false && isFitting) {
+
+		// the first bytes of the body get a buffer
+			// that can hold the whole body if its
+			// length is known
+		if (mMemoryBody.empty())
+			BufferPool::acquire(mMemoryBody, mBodyType == CONTENT_LENGTH
+				? mContentLength : mMemoryLimit);
+
+		mMemoryBody.append(data, size);
+		return ;
+
+	}
+
+	if (mIsStoreOpen == false)
+		moveToStore();
+
+	writeToStore(data, size);
 
 }
 
-bool RequestBody::parseChunkSize
-	(std::string::size_type& readBytes) {
-	
-	// searches for the end of chunk
-		// size line position starting
-		// from the last position
-		// of the consumed data
-	const std::string::size_type
-		chunkLineEndPos = mBuffer.find("\r\n", readBytes);
-	
-	// chunk size line not found
-	if (chunkLineEndPos == std::string::npos) {
-		// request body too large
-		if (mMaxBodySize && mTotalReadBytes 
-			+ mBuffer.size()  > mMaxBodySize) {
+void RequestBody::flushBody() {
+
+	try {
+
+		if (mMultipart) {
+
+			// the close delimiter wasn't received
+			if (mMultipart->isComplete() == false) {
+				mStatusCode = StatusCodeHandler::BAD_REQUEST;
+				throw std::runtime_error("flushBody(): "
+					"incomplete multipart body");
+			}
+
+			return ;
 
-			setError(StatusCodeHandler::ENTITY_LARGE);
-			readBytes = std::string::npos;
-			return false;
-		
 		}
-		// retries in next call
-		return false;
+
+		// an upload body that's still in memory is
+			// written to its file at once
+		if (mIsStoreOpen == false && mBodyFile == NULL)
+			moveToStore();
+
+		// a TempFile isn't buffered
+		if (mBodyFile)
+			return ;
+
+		mBodyStore.finish();
+
+		// the file appears in the upload directory
+			// only once it's complete
+		if (mIsInPlace == false
+			&& mBodyStore.commit(mBodyStorePath) == false) {
+			mStatusCode = StatusCodeHandler::SERVER_ERROR;
+			throw std::runtime_error("flushBody(): '"
+				+ mBodyStorePath + "' already exists");
+		}
+
+	}
+	catch (const std::exception& error) {
+		setStoreError();
+		throw ;
 	}
 
+}
 
-	// found but exceeds limit (including the 2 bytes of the CRLF)
-	if (mMaxBodySize && mTotalReadBytes 
-		+ chunkLineEndPos + 2 > mMaxBodySize) {
+void RequestBody::moveToStore() {
 
-		setError(StatusCodeHandler::ENTITY_LARGE);
-		readBytes = std::string::npos;
-		return false;
-	
+	openBodyStore();
+	mIsStoreOpen = true;
+
+	if (mMemoryBody.empty() == false)
+		writeToStore(mMemoryBody.data(), mMemoryBody.size());
+
+	// the buffer can be used by another body
+	BufferPool::release(mMemoryBody);
+
+}
+
+void RequestBody::openBodyStore() {
+
+	// the body of a TempFile is kept in memory
+		// until it grows large
+	if (mBodyFile) {
+		mBodyFile->create(TempFile::MEMORY);
+		return ;
 	}
 
-	// chunk size line found
+	// creates the file in the directory of its
+		// path to which it's committed at the end
 	try {
-		// extract the decimal value from the chunk size line
-		mChunkSize = hexToDecimal<int>
-			(mBuffer.substr(readBytes, chunkLineEndPos));
 
-		// the size that need to be read inclding the 2 bytes of the chunk
-			// separator (CRLF) exceeds the max body size
-		if (mMaxBodySize && chunkLineEndPos + 2 + mChunkSize
-			 + 2 + mTotalReadBytes > mMaxBodySize) {
+		if (mIsInPlace)
+			mBodyStore.openAt(mBodyStorePath, mStoreOffset);
+		else
+			mBodyStore.create(mBodyStorePath.substr(0,
+				mBodyStorePath.rfind('/')), mIsDirect);
 
-			setError(StatusCodeHandler::ENTITY_LARGE);
-			readBytes = std::string::npos;
-			return false;
-		
+	}
+	// file couldn't be opened
+	catch (const std::exception& error) {
+
+		mStatusCode = StatusCodeHandler::SERVER_ERROR;
+
+		const std::string errorMsg =
+			std::string("openBodyStore(): couldn't open file: '")
+			+ mBodyStorePath + '\'';
+		throw std::runtime_error(errorMsg);
+
+	}
+
+	mBodyStore.setSync(mSyncPolicy, mSyncInterval);
+
+	// the whole body is allocated at once
+	if (mBodyType == CONTENT_LENGTH)
+		mBodyStore.preallocate(mStoreOffset + mContentLength);
+
+}
+
+void RequestBody::writeToStore(const char* data, const size_t size) {
+
+	if (mBodyFile) {
+		mBodyFile->write(data, size);
+		return ;
+	}
+
+	// the file gets large writes instead of one
+		// for each read from the socket
+	mBodyStore.write(data, size);
+
+}
+
+bool RequestBody::isSpliceable() const {
+
+#if defined(__linux__) && defined(SPLICE_F_MOVE)
+	// only an upload body that's too large for the memory,
+		// whose end is known and that isn't parsed (the direct
+		// writes need aligned blocks that splice() doesn't make)
+	return (mDone == false && mBodyType == CONTENT_LENGTH
+		&& mBodyFile == NULL && mMultipart == NULL
+		&& mContentLength > mMemoryLimit && mIsDirect == false);
+#else
+	return false;
+#endif
+
+}
+
+ssize_t RequestBody::spliceFrom(const int socket) {
+
+#if defined(__linux__) && defined(SPLICE_F_MOVE)
+	try {
+
+		if (mIsStoreOpen == false)
+			moveToStore();
+
+		// the parsed bytes go to the file before the spliced ones
+		mBodyStore.flush();
+
+		if (mSplicePipe[0] == -1)
+			openSplicePipe();
+
+	}
+	catch (const std::exception& error) {
+		setStoreError();
+		throw ;
+	}
+
+	// never more than the body so that the
+		// bytes that follow it stay in the socket
+	const size_t remaining = mContentLength - mTotalReadBytes;
+
+	const ssize_t movedBytes = splice(socket, NULL, mSplicePipe[1],
+		NULL, std::min(remaining, mSplicePipeSize), SPLICE_F_MOVE);
+
+	if (movedBytes < 1)
+		return movedBytes;
+
+	// the pipe is emptied into the file so that
+		// it can take the next bytes
+	for (ssize_t leftBytes = movedBytes; leftBytes; ) {
+
+		const ssize_t writtenBytes = splice(mSplicePipe[0], NULL,
+			mBodyStore.getFd(), NULL, leftBytes, SPLICE_F_MOVE);
+
+		if (writtenBytes == -1 && errno == EINTR)
+			continue;
+
+		if (writtenBytes < 1) {
+			setError(StatusCodeHandler::SERVER_ERROR);
+			throwErrnoException("RequestBody::spliceFrom()");
 		}
 
-		// the last chunk in the body entity
-		if (mChunkSize == 0) {
-			// flushes the whole body into the stream
-			mBodyStore << std::flush;
+		leftBytes -= writtenBytes;
+
+	}
+
+	mTotalReadBytes += movedBytes;
+
+	try {
+
+		// counted for the periodic syncs
+		mBodyStore.addWritten(movedBytes);
+
+		if (mTotalReadBytes == mContentLength) {
 			mDone = true;
-			return false;
+			flushBody();
 		}
-	} 
-	catch(const std::exception& error) {
-		setError(StatusCodeHandler::SERVER_ERROR);
+
+	}
+	catch (const std::exception& error) {
+		setStoreError();
 		throw ;
 	}
 
-	// add the line size and the 2 bytes
-		// of the CRLF to the consumed bytes
-	readBytes = chunkLineEndPos + 2;
+	return movedBytes;
+#else
+	static_cast<void>(socket);
+	return -1;
+#endif
+
+}
+
+void RequestBody::openSplicePipe() {
+
+	if (pipe(mSplicePipe) == -1) {
+		mSplicePipe[0] = -1;
+		throwErrnoException("RequestBody::openSplicePipe()");
+	}
 
-	// returns true if the chunk size 
-		// was retrieved successfully
-	return true;
+	// the scripts run by the server don't get it
+	fcntl(mSplicePipe[0], F_SETFD, FD_CLOEXEC);
+	fcntl(mSplicePipe[1], F_SETFD, FD_CLOEXEC);
+
+#if defined(F_SETPIPE_SZ) && defined(F_GETPIPE_SZ)
+	// a larger pipe means fewer calls per body
+		// (the capacity is left as is if it's refused)
+	fcntl(mSplicePipe[1], F_SETPIPE_SZ, mSpliceSize);
+
+	const int pipeSize = fcntl(mSplicePipe[1], F_GETPIPE_SZ);
+	mSplicePipeSize = pipeSize > 0 ? pipeSize : 65536;
+#else
+	mSplicePipeSize = 65536;
+#endif
 
 }
 
+std::string::size_type 
+	RequestBody::parseChunkedBody() {
+
+	const char* data = mBuffer.data();
+
+	// stores the bytes consumed from mBuffer
+	std::string::size_type readBytes = 0;
+
+	// keeps pasing mBuffer until no more
+		// data is availble or the body ends
+	while (readBytes != mBuffer.size() && mDone == false) {
+
+		const size_t size = mBuffer.size() - readBytes;
+
+		// the data of a chunk is stored as a whole
+			// and the bytes around it one by one
+		const std::string::size_type parsedBytes
+			= mChunkState == CHUNK_DATA
+			? parseChunkData(data + readBytes, size)
+			: parseChunkLine(data + readBytes, size);
+
+		if (parsedBytes == std::string::npos)
+			return std::string::npos;
+
+		readBytes += parsedBytes;
+
+		// add the consumed bytes to the total
+			// bytes consumed from the body
+		mTotalReadBytes += parsedBytes;
 
-bool  RequestBody::parseChunkData
-	(std::string::size_type& readBytes) {
-	
-	// stores the size of data not consumed yet
-	const int remaining = mBuffer.size() - readBytes;
-
-	// set to the size of bytes that will be parsed
-		// to the body storage file
-	// set to the available data size if it's less than 
-		// the chunk size that still need to be read
-	// otherwise , set to the chunk size
- 	const std::string::size_type  chunkReadSize 
-		= remaining < mChunkSize 
-		? remaining: mChunkSize;
-
-	// write the unconsumed data 
-		// to the body storage file
-	// rethrow the error on stream failure
-	try {
-		writeToStream(mBodyStore, mBuffer.c_str() 
-			+ readBytes, chunkReadSize);
 	}
-	catch(const std::exception& error) {
-		setError(StatusCodeHandler::SERVER_ERROR);
-		throw ;
+
+	// request body too large
+	if (mMaxBodySize && mTotalReadBytes > mMaxBodySize) {
+		setError(StatusCodeHandler::ENTITY_LARGE);
+		return std::string::npos;
 	}
 
-	// updates the chunk size for next
-		// calls
-	mChunkSize -= chunkReadSize;
+	// returns the consumed bytes after each call
+	return readBytes;
 
-	// adds the bytes read from the chunk
-		// to the number of bytes consumed
-	readBytes += chunkReadSize ;
+}
 
-	// the chunk parsing not done
-		// yet, more data needed
-	if (mChunkSize != 0)
-		return false;
+std::string::size_type RequestBody::parseChunkLine
+	(const char* data, const size_t size) {
+
+	// the largest size that can take another digit
+	static const Size maxChunkSize = static_cast<Size>(-1) >> 4;
+
+	for (size_t i = 0; i < size; ++i) {
+
+		const unsigned char byte = data[i];
+
+		if (++mChunkLineSize > mMaxChunkLineSize) {
+			setError(StatusCodeHandler::BAD_REQUEST);
+			return std::string::npos;
+		}
+
+		switch (mChunkState) {
+
+			case CHUNK_SIZE: {
+
+				const int digit = mHexValues[byte];
+
+				if (digit != -1 && mChunkSize > maxChunkSize) {
+					setError(StatusCodeHandler::ENTITY_LARGE);
+					return std::string::npos;
+				}
+
+				if (digit != -1)
+					mChunkSize = mChunkSize * 16 + digit;
+				// the size needs at least one digit
+				else if (mChunkLineSize == 1)
+					break;
+				else if (byte == ';' || byte == ' ' || byte == '\t')
+					mChunkState = CHUNK_EXTENSION;
+				else if (byte == '\r')
+					mChunkState = CHUNK_SIZE_LF;
+				else
+					break;
+
+				continue;
+
+			}
+
+			// the extensions aren't used so they're
+				// skipped up to the end of the line
+			case CHUNK_EXTENSION: {
+
+				const char* lineEnd = static_cast<const char*>
+					(std::memchr(data + i, '\r', size - i));
+
+				const size_t skipped = lineEnd
+					? lineEnd - (data + i) : size - i - 1;
+
+				mChunkLineSize += skipped;
+				i += skipped;
+
+				if (lineEnd)
+					mChunkState = CHUNK_SIZE_LF;
+
+				continue;
+
+			}
+
+			case CHUNK_SIZE_LF:
+
+				if (byte != '\n')
+					break;
+
+				mChunkLineSize = 0;
+
+				// the last chunk is followed by the trailers
+				if (mChunkSize == 0) {
+					mChunkState = TRAILER_START;
+					continue;
+				}
+
+				// the size that needs to be read including the
+					// 2 bytes of the chunk separator (CRLF)
+					// exceeds the max body size
+				if (mMaxBodySize && mTotalReadBytes + i + 1 + 2
+					+ mChunkSize > mMaxBodySize) {
+					setError(StatusCodeHandler::ENTITY_LARGE);
+					return std::string::npos;
+				}
+
+				mChunkState = CHUNK_DATA;
+				return i + 1;
+
+			case CHUNK_DATA_CR:
+
+				if (byte != '\r')
+					break;
+
+				mChunkState = CHUNK_DATA_LF;
+				continue;
+
+			case CHUNK_DATA_LF:
+
+				if (byte != '\n')
+					break;
+
+				mChunkState = CHUNK_SIZE;
+				mChunkLineSize = 0;
+				continue;
+
+			case TRAILER_START:
+
+				mChunkState = byte == '\r' ? LAST_LF : TRAILER_FIELD;
+				continue;
+
+			// the trailer fields aren't used so they're
+				// skipped up to the end of their line
+			case TRAILER_FIELD: {
+
+				const char* lineEnd = static_cast<const char*>
+					(std::memchr(data + i, '\r', size - i));
+
+				const size_t skipped = lineEnd
+					? lineEnd - (data + i) : size - i - 1;
+
+				mChunkLineSize += skipped;
+				i += skipped;
+
+				if (lineEnd)
+					mChunkState = TRAILER_LF;
+
+				continue;
+
+			}
+
+			case TRAILER_LF:
+
+				if (byte != '\n')
+					break;
+
+				mChunkState = TRAILER_START;
+				continue;
+
+			case LAST_LF:
+
+				if (byte != '\n')
+					break;
+
+				// flushes the whole body into the stream
+				mDone = true;
+				flushBody();
+
+				return i + 1;
+
+			case CHUNK_DATA:
+				return i;
+
+		}
+
+		// a byte that isn't expected
+		setError(StatusCodeHandler::BAD_REQUEST);
+		return std::string::npos;
+
+	}
+
+	return size;
 
-	// the whole chunk parsing is done
-	return true;
-	
 }
 
-bool RequestBody::parseChunkSeparator
-			(std::string::size_type& readBytes) {
-	
-	// stores the size of data not consumed yet
-	const int remaining = mBuffer.size() - readBytes;
+std::string::size_type RequestBody::parseChunkData
+	(const char* data, const size_t size) {
 
-	// the chunk data not fully parsed
-		// or the chunk separator
-		// not read yet
-	if (mChunkSize != 0 || remaining < 2)
-		return false;
+	// the available data if it's less than the
+		// chunk size that still needs to be read
+	const size_t chunkReadSize = mChunkSize < size ? mChunkSize : size;
+
+	// write the data to the body store at once
+	// rethrow the error on stream failure
+	try {
+		storeBody(data, chunkReadSize);
+	}
+	catch(const std::exception& error) {
+		setStoreError();
+		throw ;
+	}
 
-	// to indicates that the whole
-		// chunk parsing is done
-		// including the separator (CRLF)
-	mChunkSize = -1;
+	// updates the chunk size for next
+		// calls
+	mChunkSize -= chunkReadSize;
 
-	// add the separator size
-		// to the consumed bytes
-	readBytes += 2;
+	// the separator (CRLF) follows the data
+	if (mChunkSize == 0)
+		mChunkState = CHUNK_DATA_CR;
 
-	return true;
+	return chunkReadSize;
 
 }
@@ -1,7 +1,27 @@
 /* this file contains the definition of the RequestBody class.
  * This class is responsible for parsing a request body either using
  * 	the content-length or transfer-encoding (chunked) to determine the
- * 	length of the body. The body will be appended to a specified file.
+ * 	length of the body. The body will be appended to a specified file
+ * 	(or to an anonymous TempFile).
+ * A body that fits in the memory limit is kept in a pooled buffer
+ * 	(BufferPool) and its store isn't even opened: a CGI body is read
+ * 	from memory and an upload body is written to its file at once
+ * 	when it's complete. Once the body grows past the limit, the
+ * 	buffer is moved to the store which gets the rest of the body.
+ * On linux, the rest of an upload body whose length is known and
+ * 	that doesn't fit in memory can be moved from the socket to its
+ * 	file with splice() through a pipe (see spliceFrom()) so that it's
+ * 	never copied to the server's memory.
+ * A chunked body is decoded in place by a state machine: the bytes
+ * 	around the data (size lines, CRLFs and trailers) are parsed one by
+ * 	one, which lets them be split between any two reads, while the
+ * 	data of each chunk is stored as a whole. The chunk extensions and
+ * 	the trailer fields are skipped.
+ * A multipart/form-data upload body is given to a MultipartParser
+ * 	instead, which writes the files it contains as they arrive.
+ * The file of an upload is written by a FileWriter which reserves the
+ * 	space of a body whose length is known and writes it in large blocks.
+ * 	It only appears at its path once the whole body is written.
  * The body will be read from a string buffer that will need to get
  * 	updated from an external module until the full body is read.
  * 	as long as the full body isn't read yet, a call to parse() needs
@@ -14,12 +34,18 @@
 
 #pragma once
 
-#include <fstream>
 #include <string>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
 #include <Config.hpp>
 #include <StatusCodeHandler.hpp>
 #include <stdexcept>
 #include <utils.hpp>
+#include <TempFile.hpp>
+#include <BufferPool.hpp>
+#include <FileWriter.hpp>
+#include <MultipartParser.hpp>
 
 class RequestBody {
 
@@ -35,14 +61,22 @@ class RequestBody {
 		typedef Config::Size Size;
 		typedef StatusCodeHandler::StatusCodeType
 			StatusCodeType;
+		typedef FileWriter::SyncPolicy SyncPolicy;
 
 		/******* public member functions *******/
 		// takes the buffer from which the body
 			// will be read
 		// also the maximum size that the body
 			// shoudln't exceed
+		// and the size up to which the body is kept
+			// in memory (0 if it's never kept)
 		RequestBody(const std::string& buffer,
-			const Size maxBodySize);
+			const Size maxBodySize, const Size memoryLimit);
+
+		// gives back the buffers to the pool and
+			// closes the store (see setBodyStore()
+			// for an interrupted body)
+		~RequestBody();
 
 		// returns true if parsing is over
 		bool isDone();
@@ -50,12 +84,29 @@ class RequestBody {
 		// returns true is request body is still valid
 		bool isValid();
 
+		// returns true if the body wasn't written to its
+			// store and is only in getMemoryBody()
+		bool isInMemory() const;
+
 		// returns the number of consumed bytes
 			// from the buffer
 		// throws std::exception on error
 		// qlso returns std::string::npos on error
 		std::string::size_type parse();
 
+		// returns true if the rest of the body can be
+			// moved with spliceFrom() instead of
+			// being parsed from the buffer
+		bool isSpliceable() const;
+
+		// moves the next bytes of the body from socket to
+			// the store without reading them
+		// returns the number of moved bytes, 0 on end of
+			// file or -1 if socket couldn't be read
+		// sets the status code and throws std::exception
+			// if the store couldn't be written
+		ssize_t spliceFrom(const int socket);
+
 		/******* setters *******/
 		/* these setters should be called once
 		 *  before starting the iterative
@@ -63,11 +114,39 @@ class RequestBody {
 		 */
 		void setBodyType(const BodyType type);
 
-		// opens file to be used for body storage
+		// sets the file to be used for body storage
+			// which is created (unnamed in its directory) once
+			// the body doesn't fit in memory or once the whole
+			// body is parsed and gets its path once the whole
+			// body is written
 		// if it couldn't be opened, the status code is set
-		// throws std::runtime_error on error
+			// and std::runtime_error is thrown by parse()
 		void setBodyStore(const std::string& filePath);
 
+		// same as above but the body is written into filePath
+			// (created if it doesn't exist) from offset on
+			// instead of a new file
+		// the received bytes are written even if the body
+			// is interrupted
+		void setBodyStore(const std::string& filePath,
+			const Size offset);
+
+		// same as above but the body is appended to file
+			// (which should outlive the parsing) and stays
+			// in memory if it fits there
+		void setBodyStore(TempFile& file);
+
+		// same as above but the body is given to parser (which
+			// should outlive the parsing) as it's parsed
+		// a malformed multipart body sets a bad request error
+		void setBodyStore(MultipartParser& parser);
+
+		// sets how the file set with setBodyStore() is
+			// synced and if it's written with O_DIRECT
+			// (see FileWriter)
+		void setStoreOptions(const SyncPolicy syncPolicy,
+			const Size syncInterval, const bool isDirect);
+
 		// converts contentLength to integral type and
 		// checks if it's more than max body size
 		// or if it's an invalid length
@@ -80,7 +159,35 @@ class RequestBody {
 			// an error status code is returned
 		StatusCodeType getStatusCode();
 
+		// the body if isInMemory() is true
+		const std::string& getMemoryBody() const;
+
 	private:
+		/******* private nested types *******/
+		// part of a chunked body that's expected next
+		enum ChunkState {
+			// the hexadecimal digits of a size line
+			CHUNK_SIZE,
+			// the extensions that follow the size
+			CHUNK_EXTENSION,
+			// the LF that ends a size line
+			CHUNK_SIZE_LF,
+			// the data of a chunk
+			CHUNK_DATA,
+			// the CRLF that follows the data
+			CHUNK_DATA_CR,
+			CHUNK_DATA_LF,
+			// the start of a trailer field or of the
+				// empty line that ends the body
+			TRAILER_START,
+			// the rest of a trailer field
+			TRAILER_FIELD,
+			// the LF that ends a trailer field
+			TRAILER_LF,
+			// the LF of the empty line that ends the body
+			LAST_LF
+		};
+
 		/******* private member objects *******/
 		const std::string& mBuffer;
 
@@ -88,10 +195,42 @@ class RequestBody {
 		// a value of 0 means there is no size limit
 		const Size mMaxBodySize;
 
-		// file where parsed body will be stored
+		// the body is kept in mMemoryBody as long
+			// as it doesn't grow past this size
+		const Size mMemoryLimit;
+
+		// the body (or its start) before it's moved
+			// to the store
+		std::string mMemoryBody;
+
+		// path of the file where parsed body will be stored
 			// It's necessary to use setBodyStore()
 			// before starting the parsing process
-		std::ofstream mBodyStore;
+		std::string mBodyStorePath;
+
+		// writes mBodyStorePath once it's opened
+		FileWriter mBodyStore;
+
+		// options of mBodyStore
+		SyncPolicy mSyncPolicy;
+		Size mSyncInterval;
+		bool mIsDirect;
+
+		// set if the body is written into the existing
+			// mBodyStorePath from mStoreOffset on (which
+			// is then never committed)
+		bool mIsInPlace;
+		Size mStoreOffset;
+
+		// used instead of mBodyStore if it's set
+		TempFile* mBodyFile;
+
+		// used instead of the stores if it's set
+		MultipartParser* mMultipart;
+
+		// set once the store is opened (from that point
+			// the body is written to it)
+		bool mIsStoreOpen;
 
 		BodyType mBodyType;
 
@@ -108,11 +247,36 @@ class RequestBody {
 		// that have parsed and consumed so far
 		std::string::size_type mTotalReadBytes;
 
-		// keeps track of the chunk size
-			// that needs to be read
-		// set to -1 if the chunk size
-			// not retrieved yet
-		int mChunkSize;
+		// pipe through which the body is spliced
+			// (-1 until it's needed)
+		int mSplicePipe[2];
+
+		// capacity of mSplicePipe which is the most
+			// that can be spliced at once
+		size_t mSplicePipeSize;
+
+		// capacity requested for mSplicePipe
+		static const size_t mSpliceSize;
+
+		// part of the chunked body that's being parsed
+		ChunkState mChunkState;
+
+		// size of the current chunk while its size line is
+			// parsed then the size of its data that still
+			// needs to be read
+		Size mChunkSize;
+
+		// bytes of the current size line (or of the trailer
+			// section) that were parsed so far
+		size_t mChunkLineSize;
+
+		// value of each hexadecimal digit and -1
+			// for the other bytes
+		static const signed char mHexValues[256];
+
+		// size that a chunk size line (with its extensions)
+			// or the trailer section can't exceed
+		static const size_t mMaxChunkLineSize;
 
 		/******* private member functions *******/
 		// parses body when body type is CONTENT_LENGTH
@@ -128,49 +292,61 @@ class RequestBody {
 		// also returns std::string::npos on error
 		std::string::size_type parseChunkedBody();
 
-		// parses the chunk size line and sets
-			// the chunk size
-		// takes the readBytes parameter and update
-			// it by adding the full lenght
-			// of the chunk size line if found
-		// returns false in the following cases:
-		// line note found
-		// returns false on error and sets readBytes 
-			// to std::string::npos
-		// the chunk size is 0, which is the case of the
-			// last chunk in the body entity,
-			// sets mDone to true and add updates
-			// the readBytes by adding the full
-			// line size
-		// returns true if the chunkSize was 
-			// retrieved successfully 
-			// and updates the readBbytes
-		// throws exception on error
-		bool parseChunkSize
-			(std::string::size_type& readBytes);
-
-		// returns true if the whole chunk data is 
-			// parsed (chunk size == 0)
-		// takes the readBytes parameter and 
-			// updates it by adding the 
-			// consumed chunk data size
-		// updates the mChunkSize by subtracting
-			// the read bytes from it
-		bool parseChunkData
-				(std::string::size_type& readBytes);
-
-		// returns false if the chunk separator
-			// (CRLF) not found, otherwise updates
-			// the readBytes parameter by adding
-			// the 2 bytes of the CRLF, and sets
-			// the chunk size to -1 to indicate
-			// that the whole chunk was parsed
-			// successfully
-		bool parseChunkSeparator
-			(std::string::size_type& readBytes);
+		// parses the bytes that surround the chunk data (the size
+			// lines, the CRLFs after the data and the trailer
+			// section) from the size bytes of data until the
+			// data of a chunk or the end of the body
+		// the chunk extensions and the trailer fields are skipped
+		// returns the number of consumed bytes or std::string::npos
+			// if they are invalid (and sets the status code)
+		// throws std::exception if the body couldn't be flushed
+		std::string::size_type parseChunkLine
+			(const char* data, const size_t size);
+
+		// stores the data of the current chunk from the
+			// size bytes of data at once
+		// returns the number of consumed bytes
+		// throws std::exception on error
+		std::string::size_type parseChunkData
+			(const char* data, const size_t size);
 
 		// sets the status and code and marks
 			// the parsing as done
 		void setError(StatusCodeType code);
 
+		// sets a server error when the body couldn't be stored
+			// unless the store already set an error
+		void setStoreError();
+
+		// appends size bytes of data to the memory body
+			// or to the body store if it doesn't fit there
+		// throws std::exception on error
+		void storeBody(const char* data, const size_t size);
+
+		// flushes the body store once the whole body is parsed
+			// (writing an upload body that's still in memory)
+		// sets the status code and throws std::exception on error
+		void flushBody();
+
+		// opens the store and moves the memory body to it
+		// throws std::exception on error
+		void moveToStore();
+
+		// opens the store set with setBodyStore()
+		// throws std::exception on error
+		void openBodyStore();
+
+		// appends size bytes of data to the opened store
+		// throws std::exception on error
+		void writeToStore(const char* data, const size_t size);
+
+		// creates mSplicePipe
+		// throws std::exception on error
+		void openSplicePipe();
+
+		// the store can't be closed twice
+		RequestBody(const RequestBody&);
+
+		RequestBody& operator=(const RequestBody&);
+
 };
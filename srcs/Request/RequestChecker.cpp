@@ -15,11 +15,50 @@ bool RequestChecker::isValid() {
 		// config data about the request path
 	mLocation = mRequest.getLocation();
 
-	// saves if the file exists so that it's used
+	// a location served from an asset pack
+		// never touches the filesystem
+	const AssetPack* pack = AssetPack::get(mLocation);
+	if (pack)
+		return isAsset(*pack);
+
+	// resolves the path once so that its metadata is used
 		// by the checking functions that are called next
-	mIsPath = isPath(mRequest.getFullPath());
-	mIsDir = isDir(mRequest.getFullPath());
-	
+		// and its descriptor by the response
+	FileInfo& fileInfo = mRequest.getFileInfo();
+	fileInfo.open(mRequest.getFullPath());
+
+	mIsPath = fileInfo.isPath();
+	mIsDir = fileInfo.isDir();
+
+	// the path didn't change since it was classified
+	const Request::Route* cachedRoute = mRequest.getCachedRoute();
+	if (cachedRoute && cachedRoute->isPath == mIsPath
+		&& cachedRoute->isDir == mIsDir) {
+
+		mRequest.setRequestType(cachedRoute->requestType);
+		mRequest.setStatusCode(cachedRoute->statusCode);
+		return cachedRoute->isValid;
+
+	}
+
+	Request::Route route;
+	route.location = mLocation;
+	route.fullPath = mRequest.getFullPath();
+	route.isValid = classify();
+	route.requestType = mRequest.getRequestType();
+	route.statusCode = mRequest.getStatusCode();
+	route.isPath = mIsPath;
+	route.isDir = mIsDir;
+
+	RouteCache::store(mRequest.getServer(),
+		mRequest.getMethod(), mRequest.getPath(), route);
+
+	return route.isValid;
+
+}
+
+bool RequestChecker::classify() {
+
 	if ( isMethodAllowed() == false)
 		return false;
 
@@ -40,6 +79,49 @@ bool RequestChecker::isValid() {
 
 }
 
+bool RequestChecker::isAsset(const AssetPack& pack) {
+
+	if ( isMethodAllowed() == false)
+		return false;
+
+	if ( isRedirect() )
+		return true;
+
+	// the pack is read-only
+	if (mRequest.getMethod() != Request::GET) {
+		mRequest.setStatusCode(StatusCodeHandler::METHOD_ALLOW);
+		return false;
+	}
+
+	// the path within the pack is the part of the
+		// requested path that follows the location route
+		// (a location ending with '/' also matches the
+		// path without it, which is the root of the pack)
+	const std::string& requestPath = mRequest.getPath();
+	std::string path(requestPath,
+		std::min(mLocation->route.size(), requestPath.size()));
+	if (path.empty() || path[0] != '/')
+		path.insert(0, 1, '/');
+
+	// a directory is served with its default file
+	if (path[path.size() - 1] == '/'
+		&& mLocation->defaultFile.empty() == false) {
+		path.erase(path.size() - 1);
+		path += mLocation->defaultFile;
+	}
+
+	AssetPack::Entry asset;
+	if (pack.find(path, asset) == false) {
+		mRequest.setStatusCode(StatusCodeHandler::NOT_FOUND);
+		return false;
+	}
+
+	mRequest.setAsset(asset);
+	mRequest.setRequestType(Request::ASSET);
+	return true;
+
+}
+
 bool RequestChecker::isMethodAllowed() {
 
 	const Request::Method& method
@@ -56,6 +138,10 @@ bool RequestChecker::isMethodAllowed() {
 	if (method == Request::DELETE)
 		if (mLocation->del)
 			return true;
+
+	if (method == Request::PUT)
+		if (mLocation->put)
+			return true;
 	
 	// sets the status code to method not allowed
 	mRequest.setStatusCode(StatusCodeHandler::METHOD_ALLOW);
@@ -141,6 +227,19 @@ bool RequestChecker::isAutoIndex() {
 
 bool RequestChecker::isUpload() {
 
+	// a PUT request uploads the file it names (which
+		// is created or replaced) and it can't be
+		// a directory
+	if (mRequest.getMethod() == Request::PUT) {
+
+		if (mIsDir || mLocation->uploadRoute.empty())
+			return false;
+
+		mRequest.setRequestType(Request::UPLOAD);
+		return true;
+
+	}
+
 	// checks if the method is post,
 		// full path of the requested 
 		// resource is a directory and the 
@@ -11,10 +11,12 @@
 // the include of this class is at the bottom
 	// of this file with the explanation
 class Request;
+#include <algorithm>
 
 #include <Config.hpp>
 #include <utils.hpp>
 #include <StatusCodeHandler.hpp>
+#include <AssetPack.hpp>
 
 class RequestChecker {
 
@@ -34,10 +36,24 @@ class RequestChecker {
 			// sets the response status code
 			// and the request type according
 			// to the nature of the request
+		// the result of a route found in RouteCache is reused
+			// if the requested path is still in the same state,
+			// otherwise the request is classified again and
+			// its route is stored in RouteCache
 		bool isValid();
 	
 	private:
 		/******* private member functions *******/
+		// checks the method and determines the type of
+			// the request (the logic of isValid())
+		bool classify();
+
+		// checks the request of a location that's served from
+			// pack and looks up the requested file in it
+		// it's never stored in RouteCache since the
+			// lookup is as cheap as the cache's
+		bool isAsset(const AssetPack& pack);
+
 		// checks if the requested method
 			// is allowed for the requested path
 		// sets request's status code appropriately if the
@@ -126,6 +126,13 @@ void RequestHeaders::setHeaderNames() {
 	mHeaderNames.insert("transfer-encoding");
 	mHeaderNames.insert("host");
 	mHeaderNames.insert("cookie");
+	mHeaderNames.insert("range");
+	mHeaderNames.insert("if-range");
+	mHeaderNames.insert("content-range");
+	mHeaderNames.insert("if-none-match");
+	mHeaderNames.insert("if-modified-since");
+	mHeaderNames.insert("accept-encoding");
+	mHeaderNames.insert("expect");
 
 	mHeaderNamesSet = true;
 
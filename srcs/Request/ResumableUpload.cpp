@@ -0,0 +1,198 @@
+/* this file contains the implementation of the ResumableUpload class */
+
+#include <ResumableUpload.hpp>
+
+ResumableUpload::ResumableUpload()
+	: mStart()
+	, mLength()
+	, mTotal()
+	, mOffset() {}
+
+ResumableUpload::StatusCodeType ResumableUpload::start(
+	const std::string& directory, const std::string& name,
+	const std::string* contentRange, const Size* contentLength) {
+
+	if (isValidName(name) == false)
+		return StatusCodeHandler::BAD_REQUEST;
+
+	bool isQuery = false;
+
+	if (contentRange && parseContentRange(*contentRange,
+		isQuery) == false)
+		return StatusCodeHandler::BAD_REQUEST;
+
+	// only a request that asks for the state
+		// of the upload has no body
+	if (isQuery == false && contentLength == NULL)
+		return StatusCodeHandler::LEN_REQUIRED;
+
+	// the whole file is sent at once
+	if (contentRange == NULL) {
+		mStart = 0;
+		mLength = *contentLength;
+		mTotal = *contentLength;
+	}
+	else if ((isQuery && contentLength && *contentLength)
+		|| (isQuery == false && mLength != *contentLength))
+		return StatusCodeHandler::BAD_REQUEST;
+
+	mPath = directory + '/' + name;
+
+	// an upload of another length is another upload
+	mPartPath = directory + "/." + name + '.'
+		+ toString(mTotal) + ".part";
+
+	readOffset();
+
+	if (isQuery == false && mStart > mOffset)
+		return StatusCodeHandler::RANGE_NOT_SATISFIABLE;
+
+	if (isQuery == false)
+		return StatusCodeHandler::OK;
+
+	// the upload was already completed
+	struct stat info;
+	if (mOffset == 0 && stat(mPath.c_str(), &info) == 0
+		&& S_ISREG(info.st_mode)
+		&& static_cast<Size>(info.st_size) == mTotal) {
+		mOffset = mTotal;
+		return StatusCodeHandler::CREATED;
+	}
+
+	return StatusCodeHandler::RESUME_INCOMPLETE;
+
+}
+
+ResumableUpload::StatusCodeType ResumableUpload::finish() {
+
+	readOffset();
+
+	if (mOffset < mTotal)
+		return StatusCodeHandler::RESUME_INCOMPLETE;
+
+	// the part file is on the same filesystem so the
+		// file appears at once with all its bytes
+	if (std::rename(mPartPath.c_str(), mPath.c_str()) == -1)
+		throwErrnoException("ResumableUpload::finish(): '"
+			+ mPath + '\'');
+
+	return StatusCodeHandler::CREATED;
+
+}
+
+const std::string& ResumableUpload::getPartPath() const {
+	return mPartPath;
+}
+
+ResumableUpload::Size ResumableUpload::getStart() const {
+	return mStart;
+}
+
+const std::string& ResumableUpload::getPath() const {
+	return mPath;
+}
+
+std::string ResumableUpload::getRange() const {
+
+	if (mOffset == 0)
+		return "";
+
+	return "bytes=0-" + toString(mOffset - 1);
+
+}
+
+std::string ResumableUpload::getContentRange() const {
+
+	if (mLength == 0)
+		return "bytes */" + toString(mTotal);
+
+	return "bytes " + toString(mStart) + '-'
+		+ toString(mStart + mLength - 1) + '/' + toString(mTotal);
+
+}
+
+bool ResumableUpload::parseContentRange(const std::string& value,
+	bool& isQuery) {
+
+	static const std::string unit = "bytes ";
+
+	if (value.compare(0, unit.size(), unit) != 0)
+		return false;
+
+	const std::string::size_type slashPos = value.find('/');
+	if (slashPos == std::string::npos)
+		return false;
+
+	const std::string range =
+		value.substr(unit.size(), slashPos - unit.size());
+
+	size_t total = 0;
+	if (RangeHandler::parsePosition(value.substr(slashPos + 1),
+		total) == false)
+		return false;
+
+	mTotal = total;
+
+	isQuery = (range == "*");
+
+	if (isQuery) {
+		mStart = 0;
+		mLength = 0;
+		return true;
+	}
+
+	const std::string::size_type dashPos = range.find('-');
+	if (dashPos == std::string::npos)
+		return false;
+
+	size_t first = 0;
+	size_t last = 0;
+
+	if (RangeHandler::parsePosition(range.substr(0, dashPos), first)
+		== false || RangeHandler::parsePosition(range.substr(dashPos + 1),
+		last) == false)
+		return false;
+
+	// the range must be within the file
+	if (first > last || last >= total)
+		return false;
+
+	mStart = first;
+	mLength = last - first + 1;
+
+	return true;
+
+}
+
+void ResumableUpload::readOffset() {
+
+	struct stat info;
+
+	if (stat(mPartPath.c_str(), &info) == -1) {
+		mOffset = 0;
+		return ;
+	}
+
+	mOffset = info.st_size;
+
+}
+
+bool ResumableUpload::isValidName(const std::string& name) {
+
+	// hidden names are kept for the part files
+	if (name.empty() || name[0] == '.' || name.size() > 200
+		|| name.find('/') != std::string::npos)
+		return false;
+
+	for (std::string::size_type i = 0; i < name.size(); ++i) {
+
+		const unsigned char character = name[i];
+
+		if (character < 0x20 || character == 0x7F)
+			return false;
+
+	}
+
+	return true;
+
+}
@@ -0,0 +1,113 @@
+/* this file contains the definition of the ResumableUpload class
+ * It handles a PUT request to an upload location which uploads a
+ *  file in pieces: each request sends a range of the file with a
+ *  Content-Range header (bytes first-last/length) and the server
+ *  replies with the range it has so far (308 with a Range header:
+ *  bytes=0-last) until the file is complete (201). A request with
+ *  no body whose Content-Range has an asterisk instead of the range
+ *  only asks for that range, so that a client can resume an upload
+ *  that was cut off.
+ *  A PUT without Content-Range uploads the whole file at once.
+ * The pieces are written into a hidden part file next to the file
+ *  (.name.length.part) at their offset. The size of the part file is
+ *  the offset the upload has reached, so the upload survives a restart
+ *  of the server. Once it reaches the length, the part file is renamed
+ *  to the file (which replaces an older one).
+ */
+
+#pragma once
+
+#include <string>
+#include <cerrno>
+#include <cstdio>
+#include <sys/stat.h>
+#include <Config.hpp>
+#include <StatusCodeHandler.hpp>
+#include <RangeHandler.hpp>
+#include <utils.hpp>
+
+class ResumableUpload {
+
+	public:
+		/******* alias types *******/
+		typedef Config::Size Size;
+		typedef StatusCodeHandler::StatusCodeType StatusCodeType;
+
+		/******* public member functions *******/
+		ResumableUpload();
+
+		// prepares the upload of the file name to directory
+			// from the Content-Range and Content-Length of
+			// the request (NULL if they're missing)
+		// returns OK if the body should be written to
+			// getPartPath() from getStart(), the response
+			// status if the request has nothing to write
+			// (RESUME_INCOMPLETE or CREATED) or an error
+			// status (BAD_REQUEST if the range or the name
+			// is invalid, LEN_REQUIRED if a range is sent
+			// without a length, RANGE_NOT_SATISFIABLE if the
+			// range starts after the reached offset)
+		StatusCodeType start(const std::string& directory,
+			const std::string& name, const std::string* contentRange,
+			const Size* contentLength);
+
+		// moves the part file to its path if it's complete
+			// once the body was written
+		// returns CREATED if it was moved or RESUME_INCOMPLETE
+			// if bytes are still missing
+		// throws std::runtime_error on error
+		StatusCodeType finish();
+
+		// returns the path of the part file
+		const std::string& getPartPath() const;
+
+		// returns the offset from which the body is written
+		Size getStart() const;
+
+		// returns the path of the uploaded file
+		const std::string& getPath() const;
+
+		// returns the value of the Range header that tells the
+			// client which bytes the server has (bytes=0-last)
+			// or an empty string if it has none
+		std::string getRange() const;
+
+		// returns the value of the Content-Range header
+			// of the request (or the range that was
+			// assumed if there was none)
+		std::string getContentRange() const;
+
+	private:
+		/******* private member objects *******/
+		std::string mPath;
+
+		std::string mPartPath;
+
+		// first byte and length of the range sent by the
+			// request (the last byte isn't stored since
+			// it's known from the content length)
+		Size mStart;
+		Size mLength;
+
+		// length of the whole file
+		Size mTotal;
+
+		// number of bytes the part file has
+		Size mOffset;
+
+		/******* private member functions *******/
+		// parses value (bytes first-last/total or bytes */total)
+			// into mStart, mLength and mTotal
+		// isQuery is set for the second form (mLength is 0)
+		// returns false if value is invalid
+		bool parseContentRange(const std::string& value,
+			bool& isQuery);
+
+		// sets mOffset to the size of the part file
+			// (0 if it doesn't exist)
+		void readOffset();
+
+		// returns true if name can be used as a file name
+		static bool isValidName(const std::string& name);
+
+};
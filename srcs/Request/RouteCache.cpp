@@ -0,0 +1,60 @@
+/* this file contains the implementation of the RouteCache class */
+
+#include <RouteCache.hpp>
+
+RouteCache::Servers RouteCache::mServers;
+
+const size_t RouteCache::mMaxEntries = 1024;
+
+bool RouteCache::find(ConstServerRef server, const Method method,
+	const std::string& path, Route& route) {
+
+	const Servers::iterator routes = mServers.find(&server);
+
+	if (routes == mServers.end())
+		return false;
+
+	const Entries::iterator entry =
+		routes->second.entries.find(Key(method, path));
+
+	if (entry == routes->second.entries.end())
+		return false;
+
+	// moves the key to the front of the use list
+	UseList& uses = routes->second.uses;
+	uses.splice(uses.begin(), uses, entry->second.use);
+
+	route = entry->second.route;
+
+	return true;
+
+}
+
+void RouteCache::store(ConstServerRef server, const Method method,
+	const std::string& path, const Route& route) {
+
+	ServerRoutes& routes = mServers[&server];
+	const Key key(method, path);
+
+	Entries::iterator entry = routes.entries.find(key);
+
+	if (entry != routes.entries.end()) {
+		entry->second.route = route;
+		routes.uses.splice(routes.uses.begin(),
+			routes.uses, entry->second.use);
+		return;
+	}
+
+	// evicts the least recently used route
+	if (routes.entries.size() >= mMaxEntries) {
+		routes.entries.erase(routes.uses.back());
+		routes.uses.pop_back();
+	}
+
+	routes.uses.push_front(key);
+
+	Entry& newEntry = routes.entries[key];
+	newEntry.route = route;
+	newEntry.use = routes.uses.begin();
+
+}
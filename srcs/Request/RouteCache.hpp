@@ -0,0 +1,76 @@
+/* this file contains the definition of the RouteCache class
+ * It keeps the routes of the recently requested paths of each server
+ *  so that a repeated request skips the location matching, the
+ *  building of the full path and the classification of the request
+ * A route is keyed by the request method and the normalized url path
+ *  (see URL::normalizePath()) so that the spellings of a path share
+ *  one route. It also remembers the paths that match no
+ *  location (404)
+ * A route stores whether its full path existed and was a directory,
+ *  so it's only reused while the full path, which is opened for every
+ *  request anyway, is still in the same state
+ * The number of routes of a server is bounded and the least recently
+ *  used ones are evicted to make room for new ones
+ */
+
+#pragma once
+
+#include <map>
+#include <list>
+#include <string>
+#include <utility>
+#include <Request.hpp>
+
+class RouteCache {
+
+	public:
+		/******* alias types *******/
+		typedef Request::ConstServerRef ConstServerRef;
+		typedef Request::Method Method;
+		typedef Request::Route Route;
+
+		/******* public member functions *******/
+		// looks for the route of path requested with method
+			// on server
+		// returns true and copies it to route if one is found
+		static bool find(ConstServerRef server, const Method method,
+			const std::string& path, Route& route);
+
+		// stores the route of path requested with method on
+			// server (replaces an older one if there is any)
+		static void store(ConstServerRef server, const Method method,
+			const std::string& path, const Route& route);
+
+	private:
+		/******* alias types *******/
+		typedef std::pair<Method, std::string> Key;
+
+		// keys of the routes from the most
+			// to the least recently used
+		typedef std::list<Key> UseList;
+
+		/******* private nested types *******/
+		struct Entry {
+			Route route;
+			// position of the key in the use list
+			UseList::iterator use;
+		};
+
+		typedef std::map<Key, Entry> Entries;
+
+		// routes of a single server
+		struct ServerRoutes {
+			Entries entries;
+			UseList uses;
+		};
+
+		typedef std::map<const Config::ServerContext*,
+			ServerRoutes> Servers;
+
+		/******* private member objects *******/
+		static Servers mServers;
+
+		// maximum number of routes of a server
+		static const size_t mMaxEntries;
+
+};
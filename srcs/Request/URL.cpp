@@ -13,6 +13,7 @@ URL::URL(ConstServerRef server)
 	 mValid(true),
 	 mParsed(false),
 	 mLocation(NULL),
+	 mIsRouted(false),
 	 mStatusCode(StatusCodeHandler::OK) {} 
 
 void URL::parse(const std::string& url) {
@@ -35,6 +36,21 @@ void URL::parse(const std::string& url) {
 
 }
 
+void URL::parse(const std::string& url,
+	ConstLocptr location, const FullPath& fullPath) {
+
+	if (!mParsed) {
+
+		mIsRouted = true;
+		mLocation = location;
+		mFullPath = fullPath;
+
+		parse(url);
+
+	}
+
+}
+
 void URL::parseUrl(const std::string& url) {
 
 	// if the url is empty or doesn't starts with the root
@@ -56,12 +72,8 @@ void URL::parseUrl(const std::string& url) {
 std::string::size_type
 	URL::parsePath(const std::string& url) {
 	
-	// to avoid string realloacation
-	mPath.reserve(url.size() + 1);
-
 	// parses the url path by reading and checking 
-		// each character of the url and add it to
-		//  mPath if it's valid until 
+		// each character of the url until 
 		// the end of the url or the beginning 
 		// of the query string
 	std::string::size_type i = 0;
@@ -73,15 +85,22 @@ std::string::size_type
 			return std::string::npos;
 		}
 
-		// add the valid character
-		mPath.insert(mPath.end(), url[i]);
 		++i;
 
 	}
 
+	// the location is matched against the
+		// normalized path
+	if (normalizePath(url.substr(0, i), mPath) == false) {
+		setErrorStatusCode(StatusCodeHandler::BAD_REQUEST);
+		return std::string::npos;
+	}
+
 	// sets the most specific location 
 		// that matches the url path within mServer
-	mLocation = mServer.matchLocation(mPath);
+		// unless the path was already routed
+	if (!mIsRouted)
+		mLocation = mServer.matchLocation(mPath);
 
 	// if the url path doesn't match any location 
 		// in mServer set NotFound error and invalid url
@@ -93,6 +112,80 @@ std::string::size_type
 
 }
 
+bool URL::normalizePath(const std::string& rawPath, Path& path) {
+
+	std::string decoded;
+	if (decodePath(rawPath, decoded) == false)
+		return false;
+
+	// each kept segment is followed by a slash
+	path = "/";
+	path.reserve(decoded.size() + 1);
+
+	// set when the last segment is a directory
+		// ("", "." or "..") so its slash is kept
+	bool isDirectory = true;
+
+	std::string::size_type begin = 0;
+	while (begin <= decoded.size()) {
+
+		std::string::size_type end = decoded.find('/', begin);
+		if (end == std::string::npos)
+			end = decoded.size();
+
+		const std::string segment
+			= decoded.substr(begin, end - begin);
+		begin = end + 1;
+
+		isDirectory = (segment.empty()
+			|| segment == "." || segment == "..");
+
+		// removes the last kept segment
+		if (segment == ".." && path.size() > 1)
+			path.erase(path.rfind('/', path.size() - 2) + 1);
+		else if (isDirectory == false) {
+			path += segment;
+			path += '/';
+		}
+
+	}
+
+	if (isDirectory == false)
+		path.erase(path.size() - 1);
+
+	return true;
+
+}
+
+bool URL::decodePath(const std::string& rawPath,
+	std::string& decoded) {
+
+	decoded.reserve(rawPath.size());
+
+	for (std::string::size_type i = 0; i < rawPath.size(); ++i) {
+
+		if (rawPath[i] != '%' || i + 2 >= rawPath.size()
+			|| std::isxdigit(rawPath[i + 1]) == 0
+			|| std::isxdigit(rawPath[i + 2]) == 0) {
+			decoded += rawPath[i];
+			continue;
+		}
+
+		const char c = static_cast<char>
+			(hexToDecimal<int>(rawPath.substr(i + 1, 2)));
+
+		if ((c >= 0 && c < ' ') || c == 127)
+			return false;
+
+		decoded += c;
+		i += 2;
+
+	}
+
+	return true;
+
+}
+
 bool URL::isForbiddenChar(const char c) {
 
 	// if the char is unprintable or belongs to 
@@ -134,7 +227,7 @@ void URL::addFullPath() {
 		// the prefix subpath withing the url path
 		// with the location root if it exists
 		// or the current directory if not
-	if (mLocation && mValid) {
+	if (mLocation && mValid && !mIsRouted) {
 		mFullPath = mLocation->replaceByRoot(mPath);
 	}
 
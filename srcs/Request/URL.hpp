@@ -9,12 +9,16 @@
  * is set to indicate the type of the error
  * a bad charachter means that it's either unprintable
  * or belongs to mForbiddenChars collection
+ * The path is normalized before it's routed: it's percent-decoded,
+ *  its empty and '.' segments are removed and its '..' segments
+ *  remove the segment before them (never going above the root)
  */
 
 #pragma once
 
 #include <Config.hpp> 
 #include <StatusCodeHandler.hpp>
+#include <cctype>
 
 class URL {
 
@@ -36,13 +40,22 @@ class URL {
 			//valid path , query string and full path
 		void parse(const std::string& url);
 
+		// same as above but the path was already routed to
+			// location and fullPath (by a previous request)
+			// so they are taken instead of being looked for
+		// the url is still checked for bad characters
+		// a NULL location makes the url invalid with
+			// a NOT_FOUND error
+		void parse(const std::string& url,
+			ConstLocptr location, const FullPath& fullPath);
+
 		// returns true if the url is valid 
 			// means it doesn't contain any bad characters
 			// and it matches a valid location in 
 			// the mServer 
 		bool isValid() const;
 
-		// returns the url path
+		// returns the url path (normalized)
 		const Path& getPath() const;
 
 		// returns the full path of the requested resource
@@ -64,6 +77,15 @@ class URL {
 		
 		// prints the url info
 		void print() const;
+
+		// sets path to the normalized form of rawPath
+			// (see the top of the file)
+		// a trailing slash is kept, and so is the one of
+			// a path that ends with a '.' or '..' segment
+		// returns false if a decoded character
+			// is a control character
+		static bool normalizePath(const std::string& rawPath,
+			Path& path);
 	
 	private:
 		/******* private member objects *******/
@@ -96,6 +118,10 @@ class URL {
 		// the most specific matched location with the url path
 		ConstLocptr mLocation;
 
+		// is true if mLocation and mFullPath were
+			// given to parse() instead of being looked for
+		bool mIsRouted;
+
 		// contains the unallowed characters in a url
 		static const std::string mForbiddenChars;
 
@@ -136,4 +162,13 @@ class URL {
 
 		// checks if a char is a bad character
 		bool isForbiddenChar(const char c);
+
+		// sets decoded to rawPath in which each %XX is
+			// replaced by its character (a '%' that isn't
+			// followed by 2 hex digits is kept as it is)
+		// returns false if a decoded character
+			// is a control character
+		static bool decodePath(const std::string& rawPath,
+			std::string& decoded);
+
 };
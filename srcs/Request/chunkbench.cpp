@@ -0,0 +1,93 @@
+/* chunk-bench: measures how fast RequestBody decodes chunked bodies
+ * usage: chunk-bench
+ * Each case encodes a body made of chunks of one size and feeds it to
+ *  the decoder in reads of a fixed size, like the socket would, with
+ *  /dev/null as the store so that only the decoding is measured. Tiny
+ *  chunks measure the size lines and CRLFs while huge chunks measure
+ *  the copy of their data.
+ */
+
+#include <RequestBody.hpp>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdlib>
+#include <sys/time.h>
+
+// returns the current time in seconds
+static double getSeconds() {
+
+	struct timeval time;
+	gettimeofday(&time, NULL);
+	return time.tv_sec + time.tv_usec / 1e6;
+
+}
+
+// decodes a body of about totalSize bytes made of chunks of
+	// chunkSize bytes, which is read readSize bytes at a time
+static void runCase(const std::string& name, const size_t chunkSize,
+	const size_t totalSize, const size_t readSize) {
+
+	std::ostringstream sizeLine;
+	sizeLine << std::hex << chunkSize << "\r\n";
+
+	const std::string chunk = sizeLine.str()
+		+ std::string(chunkSize, 'x') + "\r\n";
+
+	std::string encoded;
+	encoded.reserve(totalSize / chunkSize * chunk.size() + chunk.size());
+	for (size_t size = 0; size < totalSize; size += chunkSize)
+		encoded += chunk;
+	encoded += "0\r\n\r\n";
+
+	std::string buffer;
+	RequestBody body(buffer, 0, 0);
+	body.setBodyType(RequestBody::CHUNKED);
+	body.setBodyStore("/dev/null", 0);
+
+	const double start = getSeconds();
+	size_t pos = 0;
+
+	while (body.isDone() == false) {
+
+		const size_t size = std::min(readSize, encoded.size() - pos);
+		buffer.append(encoded, pos, size);
+		pos += size;
+
+		const std::string::size_type parsedBytes = body.parse();
+		if (parsedBytes == std::string::npos
+			|| body.isValid() == false)
+			throw std::runtime_error(name + ": the body is invalid");
+		buffer.erase(0, parsedBytes);
+
+	}
+
+	const double seconds = getSeconds() - start;
+
+	std::cout << std::left << std::setw(12) << name << std::right
+		<< std::fixed << std::setprecision(1)
+		<< std::setw(8) << encoded.size() / 1e6 << " MB in "
+		<< std::setprecision(3) << seconds << "s = "
+		<< std::setprecision(2) << encoded.size() / seconds / 1e9
+		<< " GB/s\n";
+
+}
+
+int main() {
+
+	try {
+
+		runCase("1B chunks", 1, 20 << 20, 64 << 10);
+		runCase("64B chunks", 64, 200 << 20, 64 << 10);
+		runCase("64KB chunks", 64 << 10, 1 << 30, 64 << 10);
+		runCase("64MB chunks", 64 << 20, 1 << 30, 1 << 20);
+
+	}
+	catch (const std::exception& error) {
+		std::cerr << error.what() << '\n';
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+
+}
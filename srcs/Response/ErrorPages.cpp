@@ -0,0 +1,124 @@
+/* this file contains the implementation of the ErrorPages class */
+
+#include <ErrorPages.hpp>
+
+std::map<const Config::ServerContext*, ErrorPages::Pages>
+	ErrorPages::mServerPages;
+
+ErrorPages::Pages ErrorPages::mDefaultPages;
+
+void ErrorPages::load(const Servers& servers) {
+
+	const StatusCodeHandler::StatusCodeMap& codes
+		= StatusCodeHandler::getStatusCodes();
+
+	for (StatusCodeHandler::StatusCodeMap::const_iterator code
+		= codes.begin(); code != codes.end(); ++code) {
+
+		if (code->first >= 400)
+			generatePage(code->first, mDefaultPages[code->first]);
+
+	}
+
+	for (Servers::const_iterator server = servers.begin();
+		server != servers.end(); ++server) {
+
+		Pages& pages = mServerPages[&*server];
+
+		for (std::map<Config::StatusCode, Path>::const_iterator
+			errorPage = server->errorPages.begin();
+			errorPage != server->errorPages.end(); ++errorPage) {
+
+			const StatusCodeType code =
+				static_cast<StatusCodeType>(errorPage->first);
+
+			// the page is looked for the same way
+				// a requested path would be
+			const Config::ConstLocPtr location
+				= server->matchLocation(errorPage->second);
+
+			Page page;
+
+			if (location == NULL || readPage
+				(location->replaceByRoot(errorPage->second), page)
+				== false) {
+
+				Log::error("error_page '" + errorPage->second
+					+ "' couldn't be read, the default "
+					"page is used instead");
+				continue;
+
+			}
+
+			pages[code] = page;
+
+		}
+
+	}
+
+}
+
+const ErrorPages::Page* ErrorPages::find(ConstServerRef server,
+	const StatusCodeType code) {
+
+	const std::map<const Config::ServerContext*, Pages>::
+		const_iterator pages = mServerPages.find(&server);
+
+	if (pages != mServerPages.end()) {
+
+		const Pages::const_iterator page = pages->second.find(code);
+		if (page != pages->second.end())
+			return &page->second;
+
+	}
+
+	const Pages::const_iterator page = mDefaultPages.find(code);
+	if (page != mDefaultPages.end())
+		return &page->second;
+
+	return NULL;
+
+}
+
+bool ErrorPages::readPage(const Path& path, Page& page) {
+
+	// directories can be opened but not read
+	FileInfo fileInfo;
+	if (fileInfo.open(path) == false || fileInfo.isRegular() == false)
+		return false;
+
+	std::ifstream file(path.c_str(), std::ios::binary);
+	if (!file)
+		return false;
+
+	std::ostringstream content;
+	content << file.rdbuf();
+
+	std::string body = content.str();
+	page.body = SharedBuffer(body);
+	page.path = path;
+
+	return true;
+
+}
+
+void ErrorPages::generatePage(const StatusCodeType code,
+	Page& page) {
+
+	const StatusCodeHandler::StatusCodePair& codeInfo
+		= StatusCodeHandler::getStatusCodeInfo(code);
+
+	const std::string title =
+		codeInfo.first + ' ' + codeInfo.second;
+
+	std::string body = "<html>\r\n"
+		"<head><title>" + title + "</title></head>\r\n"
+		"<body>\r\n"
+		"<center><h1>" + title + "</h1></center>\r\n"
+		"</body>\r\n"
+		"</html>\r\n";
+
+	page.body = SharedBuffer(body);
+	page.path.clear();
+
+}
@@ -0,0 +1,72 @@
+/* this file contains the definition of the ErrorPages class
+ * It keeps in memory the bodies of the error responses so that an
+ *  error is sent without any filesystem access
+ * The error_page files of all the servers are read once at startup,
+ *  and a small html body is generated for every error status code
+ *  that has no error_page configured (or whose file couldn't be read)
+ */
+
+#pragma once
+
+#include <string>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <Config.hpp>
+#include <StatusCodeHandler.hpp>
+#include <SharedBuffer.hpp>
+#include <FileInfo.hpp>
+#include <Log.hpp>
+
+class ErrorPages {
+
+	public:
+		/******* alias types *******/
+		typedef Config::Servers Servers;
+		typedef Config::ConstServerRef ConstServerRef;
+		typedef Config::Path Path;
+		typedef StatusCodeHandler::StatusCodeType StatusCodeType;
+
+		/******* nested types *******/
+		struct Page {
+			SharedBuffer body;
+			// full path of the error_page file whose
+				// extension gives the content type
+			// empty if the body was generated (text/html)
+			Path path;
+		};
+
+		/******* public member functions *******/
+		// reads the error_page files of all servers and
+			// generates the bodies of the other error codes
+		// should be called after
+			// StatusCodeHandler::initializeStaticData()
+		static void load(const Servers& servers);
+
+		// returns the page to be sent for code by server
+		// returns NULL if code isn't an error code
+		static const Page* find(ConstServerRef server,
+			const StatusCodeType code);
+
+	private:
+		/******* alias types *******/
+		typedef std::map<StatusCodeType, Page> Pages;
+
+		/******* private member objects *******/
+		// error_page files of each server
+		static std::map<const Config::ServerContext*, Pages>
+			mServerPages;
+
+		// generated bodies of all the error codes
+		static Pages mDefaultPages;
+
+		/******* private member functions *******/
+		// reads the whole file at path into page
+		// returns false if it couldn't be read
+		static bool readPage(const Path& path, Page& page);
+
+		// generates the html body of code
+		static void generatePage(const StatusCodeType code,
+			Page& page);
+
+};
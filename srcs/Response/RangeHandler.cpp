@@ -0,0 +1,269 @@
+/* this file contains the implementation of the RangeHandler class */
+
+#include <RangeHandler.hpp>
+
+const size_t RangeHandler::mMaxRanges = 32;
+
+RangeHandler::RangeHandler()
+	: mEntityLength() {}
+
+RangeHandler::Status RangeHandler::parse
+	(const std::string& rangeValue, const size_t entityLength) {
+
+	clear();
+
+	mEntityLength = entityLength;
+
+	// only byte ranges are supported
+	const std::string unit = "bytes=";
+	if (rangeValue.compare(0, unit.size(), unit))
+		return NONE;
+
+	// number of byte-range-specs found so far
+		// (satisfiable or not)
+	size_t specsCount = 0;
+
+	// goes through the comma separated specs
+	std::string::size_type specBegin = unit.size();
+	while (specBegin <= rangeValue.size()) {
+
+		std::string::size_type specEnd
+			= rangeValue.find(',', specBegin);
+		if (specEnd == std::string::npos)
+			specEnd = rangeValue.size();
+
+		// removes the optional white space around the spec
+		const std::string::size_type first =
+			rangeValue.find_first_not_of(" \t", specBegin);
+		std::string::size_type last =
+			rangeValue.find_last_not_of(" \t", specEnd - 1);
+
+		// empty list elements are allowed by the grammar
+		if (first != std::string::npos && first < specEnd
+			&& last != std::string::npos && last >= first) {
+
+			if (++specsCount > mMaxRanges
+				|| parseRangeSpec(rangeValue.substr
+					(first, last - first + 1)) == false) {
+
+				clear();
+				return NONE;
+
+			}
+
+		}
+
+		specBegin = specEnd + 1;
+
+	}
+
+	// at least one spec is required
+	if (specsCount == 0)
+		return NONE;
+
+	if (mRanges.empty())
+		return UNSATISFIABLE;
+
+	mergeRanges();
+
+	if (isMultipart())
+		generateBoundary();
+
+	return SATISFIABLE;
+
+}
+
+void RangeHandler::clear() {
+
+	mRanges.clear();
+	mBoundary.clear();
+
+}
+
+const RangeHandler::Ranges& RangeHandler::getRanges() const {
+	return mRanges;
+}
+
+bool RangeHandler::isMultipart() const {
+	return (mRanges.size() > 1);
+}
+
+std::string RangeHandler::getContentRange
+	(const size_t index) const {
+
+	const Range& range = mRanges.at(index);
+
+	return ("bytes " + toString(range.first) + '-'
+		+ toString(range.second) + '/'
+		+ toString(mEntityLength));
+
+}
+
+std::string RangeHandler::getUnsatisfiedContentRange() const {
+	return ("bytes */" + toString(mEntityLength));
+}
+
+std::string RangeHandler::getMultipartType() const {
+	return ("multipart/byteranges; boundary=" + mBoundary);
+}
+
+std::string RangeHandler::getPartHeader(const size_t index,
+	const std::string& contentType) const {
+
+	// the CRLF that precedes the boundary delimiter
+		// is part of the delimiter. it is also sent
+		// before the first one, which is allowed
+		// as a preamble
+	return ("\r\n--" + mBoundary + "\r\n"
+		+ "Content-Type: " + contentType + "\r\n"
+		+ "Content-Range: " + getContentRange(index)
+		+ "\r\n\r\n");
+
+}
+
+std::string RangeHandler::getClosingDelimiter() const {
+	return ("\r\n--" + mBoundary + "--\r\n");
+}
+
+size_t RangeHandler::getBodyLength
+	(const std::string& contentType) const {
+
+	size_t length = 0;
+
+	for (size_t i = 0; i < mRanges.size(); ++i) {
+
+		length += mRanges[i].second - mRanges[i].first + 1;
+
+		if (isMultipart())
+			length += getPartHeader(i, contentType).size();
+
+	}
+
+	if (isMultipart())
+		length += getClosingDelimiter().size();
+
+	return length;
+
+}
+
+bool RangeHandler::parseRangeSpec(const std::string& spec) {
+
+	const std::string::size_type dashPos = spec.find('-');
+
+	// every spec contains a dash
+	if (dashPos == std::string::npos)
+		return false;
+
+	const std::string firstStr = spec.substr(0, dashPos);
+	const std::string lastStr = spec.substr(dashPos + 1);
+
+	size_t first = 0, last = 0;
+
+	// suffix-byte-range-spec (-suffix):
+		// the last 'suffix' bytes of the entity
+	if (firstStr.empty()) {
+
+		if (parsePosition(lastStr, last) == false)
+			return false;
+
+		// a zero suffix length or an empty entity
+			// can't be satisfied
+		if (last == 0 || mEntityLength == 0)
+			return true;
+
+		first = last >= mEntityLength ?
+			0 : mEntityLength - last;
+		mRanges.push_back(Range(first, mEntityLength - 1));
+
+		return true;
+
+	}
+
+	if (parsePosition(firstStr, first) == false)
+		return false;
+
+	// first- : from first up to the end of the entity
+	if (lastStr.empty())
+		last = mEntityLength ? mEntityLength - 1 : 0;
+	else if (parsePosition(lastStr, last) == false
+		|| last < first)
+		return false;
+
+	// the range starts after the entity's end
+	if (first >= mEntityLength)
+		return true;
+
+	// last positions past the end are truncated
+	if (last >= mEntityLength)
+		last = mEntityLength - 1;
+
+	mRanges.push_back(Range(first, last));
+
+	return true;
+
+}
+
+void RangeHandler::mergeRanges() {
+
+	std::sort(mRanges.begin(), mRanges.end());
+
+	Ranges merged;
+	merged.push_back(mRanges.front());
+
+	for (Ranges::const_iterator range = mRanges.begin() + 1;
+		range != mRanges.end(); ++range) {
+
+		Range& previous = merged.back();
+
+		// overlaps or is adjacent to the previous range
+		if (range->first <= previous.second + 1) {
+			if (range->second > previous.second)
+				previous.second = range->second;
+		}
+		else
+			merged.push_back(*range);
+
+	}
+
+	mRanges.swap(merged);
+
+}
+
+bool RangeHandler::parsePosition(const std::string& str,
+	size_t& position) {
+
+	if (str.empty())
+		return false;
+
+	position = 0;
+
+	for (std::string::const_iterator c = str.begin();
+		c != str.end(); ++c) {
+
+		if (std::isdigit(*c) == false)
+			return false;
+
+		const size_t digit = *c - '0';
+
+		// checks that position * 10 + digit doesn't overflow
+		if (position > (static_cast<size_t>(-1) - digit) / 10)
+			return false;
+
+		position = position * 10 + digit;
+
+	}
+
+	return true;
+
+}
+
+void RangeHandler::generateBoundary() {
+
+	// counter that makes boundaries unique
+		// within the same second
+	static unsigned long counter = 0;
+
+	mBoundary = "flouta-otmane-" + toString(std::time(NULL))
+		+ '-' + toString(counter++);
+
+}
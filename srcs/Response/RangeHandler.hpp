@@ -0,0 +1,129 @@
+/* this file contains the definition of the RangeHandler class
+ * It is responsible for parsing the value of a Range request-header
+ *  field (byte ranges only) against the length of the entity that
+ *  will be served, and for generating the framing of a
+ *  multipart/byteranges entity body when more than one range
+ *  was requested
+ * Overlapping ranges are merged and the resulting ranges are
+ *  sorted by their first byte position
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cctype>
+#include <utils.hpp>
+
+class RangeHandler {
+
+	public:
+		/******* nested types *******/
+		// result of parsing a Range header value
+		enum Status {
+			// no usable range was found (missing, invalid
+				// or ignored header) so the full entity
+				// should be served
+			NONE,
+			// at least one range can be served
+			SATISFIABLE,
+			// none of the ranges overlap the entity
+			UNSATISFIABLE
+		};
+
+		/******* alias types *******/
+		// first and last byte positions (both inclusive)
+		typedef std::pair<size_t, size_t> Range;
+		typedef std::vector<Range> Ranges;
+
+		/******* public member functions *******/
+		RangeHandler();
+
+		// parses the value of a Range header against
+			// an entity of entityLength bytes
+		// the parsed ranges are stored in mRanges and
+			// can be retrieved with getRanges()
+		// a syntactically invalid header or one that
+			// contains more than mMaxRanges ranges
+			// is ignored (NONE is returned)
+		Status parse(const std::string& rangeValue,
+			const size_t entityLength);
+
+		// clears all parsed ranges
+		void clear();
+
+		// returns the satisfiable ranges
+		const Ranges& getRanges() const;
+
+		// returns true if the response will need a
+			// multipart/byteranges body
+		bool isMultipart() const;
+
+		// returns the content-range header value of
+			// the range at index in the format:
+			// bytes first-last/entityLength
+		std::string getContentRange(const size_t index) const;
+
+		// returns the content-range header value that's
+			// sent with a 416 response: bytes */entityLength
+		std::string getUnsatisfiedContentRange() const;
+
+		// returns the content-type header value of
+			// a multipart/byteranges response
+		std::string getMultipartType() const;
+
+		// returns the boundary and headers that
+			// precede the range at index in a
+			// multipart/byteranges body
+		// contentType is the type of the served entity
+		std::string getPartHeader(const size_t index,
+			const std::string& contentType) const;
+
+		// returns the delimiter that closes a
+			// multipart/byteranges body
+		std::string getClosingDelimiter() const;
+
+		// returns the full size of the entity body
+			// that will be sent for the parsed ranges
+			// (part headers and delimiters included
+			// in the multipart case)
+		size_t getBodyLength(const std::string& contentType) const;
+
+		// converts a string made up of digits only to a number
+		// returns false if str is empty, contains a non digit
+			// character or overflows
+		static bool parsePosition(const std::string& str,
+			size_t& position);
+
+	private:
+		/******* private member objects *******/
+		Ranges mRanges;
+
+		// length of the entity on which the
+			// ranges were applied
+		size_t mEntityLength;
+
+		// separates the parts of a
+			// multipart/byteranges body
+		std::string mBoundary;
+
+		// a Range header with more ranges than this
+			// is ignored and the full entity is served
+		static const size_t mMaxRanges;
+
+		/******* private member functions *******/
+		// parses a single byte-range-spec (first-last,
+			// first- or -suffix) and adds it to mRanges
+			// if it is satisfiable
+		// returns false if spec is syntactically invalid
+		bool parseRangeSpec(const std::string& spec);
+
+		// sorts mRanges and merges the ones that overlap
+			// or are adjacent
+		void mergeRanges();
+
+		// generates a new boundary string in mBoundary
+		void generateBoundary();
+
+};
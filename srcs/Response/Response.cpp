@@ -2,10 +2,35 @@
 
 #include <Response.hpp>
 
+const char* const Response::mHeaderNames[HEADER_FIELDS_COUNT] = {
+	"Accept-Ranges",
+	"Cache-Control",
+	"Content-Encoding",
+	"Content-Length",
+	"Content-Range",
+	"Content-Type",
+	"ETag",
+	"Expires",
+	"Last-Modified",
+	"Location",
+	"Range",
+	"Vary"
+};
+
+const std::string Response::mServerName = "Flouta-Otmane/1.0X";
+
 const size_t Response::mSendSize = 1024;
 
+const size_t Response::mBodyBufferSendSize = 256 * 1024;
+
 const size_t Response::mReadSize = 1024;
 
+const size_t Response::mReadAheadMinSize = 1024 * 1024;
+
+const size_t Response::mReadAheadSize = 2 * 1024 * 1024;
+
+const size_t Response::mDropCacheMinSize = 64 * 1024 * 1024;
+
 Response::Response(Socket socket, const Request& request,
 	ConstServerRef server, const MimeTypes& mimeTypes)
 	: mSocket(socket)
@@ -14,25 +39,48 @@ Response::Response(Socket socket, const Request& request,
 	, mLocation()
 	, mDone()
 	, mStart()
-	, mIsSeparator(true)
-	, mIsDelBodyFile()
+	, mBodyFile()
+	, mBodyPos()
+	, mIsBodyDone()
+	, mBodySize()
+	, mLastModified()
+	, mNextRange()
+	, mRangeBytesLeft()
+	, mIsCompressing()
+	, mIsCachingBody()
+	, mBodyBufferPos()
+	, mZeroCopy(socket)
+	, mBodyOffset()
+	, mIsStreamingListing()
 	, mMimeTypes(mimeTypes) {}
 
-Response::~Response() {
-
-	// deletes the file containing the body
-		// if it should be deleted
-	if (mIsDelBodyFile)
-		removeFile(mBodyFileName);
-
+bool Response::isWrite() const {
+	return (mDone == false && isRead() == false);
 }
 
-bool Response::isWrite() const {
-	return (mDone == false);
+bool Response::isRead() const {
+	return (mDone == false && (mZeroCopy.isBlocked() || (mIsBodyDone
+		&& mBuffer.empty() && mZeroCopy.isPending())));
 }
 
 void Response::proceedWithSocket() {
+
+	if (isRead() == false) {
 		sendResponse();
+		return;
+	}
+
+	// the response is done once the kernel is done with
+		// the body or once the client closed the connection
+	// otherwise, a deferred zero-copy send is retried
+		// on the next writable event
+	if (mZeroCopy.readCompletions() == false
+		|| (mIsBodyDone && mBuffer.empty()
+			&& mZeroCopy.isPending() == false)) {
+		mDone = true;
+		logResponse();
+	}
+
 }
 
 void Response::start(ConstLocPtr location) {
@@ -47,11 +95,6 @@ void Response::start(ConstLocPtr location) {
 
 	mStatusCode = mRequest.getStatusCode();
 
-	// This mandatory header is always
-		// present in the response message
-	mHeaders["Connection"] = "close";
-	mHeaders["Server"] = "Flouta-Otmane/1.0X";
-
 	generateResponse();
 
 }
@@ -61,6 +104,10 @@ const MimeTypes& Response::getMimeTypes() const {
 }
 
 void Response::generateResponse() {
+
+	// these headers are also sent with the errors
+		// of the upload
+	setUploadHeaders();
 	
 	// checks the reponse type and sets the
 		// data needed for that response type
@@ -72,6 +119,8 @@ void Response::generateResponse() {
 		;
 	else if (isContent())
 		;
+	else if (isAsset())
+		;
 	else if (isDefault())
 		;
 	else if (isRedirect())
@@ -82,7 +131,9 @@ void Response::generateResponse() {
 		;
 	}
 
-	openBodyStream();
+	setCompression();
+
+	openBodyFile();
 
 	// checks if an error happened while processing
 		// and preparing the response so that an
@@ -90,7 +141,7 @@ void Response::generateResponse() {
 	// opens a stream of the error file to be sent
 		// if there is one
 	if (isError())
-		openBodyStream();
+		openBodyFile();
 
 	generateStatusLine();
 
@@ -102,27 +153,30 @@ void Response::generateResponse() {
 
 void Response::sendResponse() {
 
+	// an in-memory body that's sent as it is
+		// doesn't go through mBuffer: it's sent
+		// once the header section is
+	const bool isSendingBodyBuffer = mIsBodyDone == false
+		&& mBodyBufferPos < mBodyBuffer.getSize()
+		&& mIsCompressing == false
+		&& mRangeHandler.getRanges().empty();
+
+	if (isSendingBodyBuffer && mBuffer.empty()) {
+		sendBodyBuffer();
+		return;
+	}
+
 	// there is a body and there are
 		// still body bytes to be sent
-	if (mBodyFileName.empty() == false && 
-		mBodyStream.eof() == false) {
+	if (isSendingBodyBuffer == false
+		&& (mBodyFileName.empty() == false || mBodyFile
+		|| mBodyBuffer.isEmpty() == false)
+		&& mIsBodyDone == false) {
 
-		char bodyBuf[mReadSize];
-
-		// fill readBodyBytes buffer from body stream
-		mBodyStream.read(bodyBuf, mReadSize);
-
-		// if it failed before reaching eof,
-			// stops sending the response
-		if (mBodyStream.eof() == false
-			&&  mBodyStream.fail()) {
-			mDone = true;
-		}
-		else {
-			// appends the number of read bytes from the stream
-				// to the send buffer
-			mBuffer.append(bodyBuf, mBodyStream.gcount());
-		}
+		if (mRangeHandler.getRanges().empty())
+			readBody();
+		else
+			readRangedBody();
 
 	}
 	// after checking the file stream,
@@ -148,8 +202,12 @@ void Response::sendResponse() {
 		const ssize_t sentBytes = write
 			(mSocket, mBuffer.c_str(), sendSize);
 
+		// the socket is full, so it's tried again
+			// once it's writable
+		if (sentBytes == -1 && isRetryError())
+			;
 		// if sending failed
-		if (sentBytes == -1)
+		else if (sentBytes == -1)
 			mDone = true;
 		else {
 			// removes the sent bytes
@@ -160,32 +218,278 @@ void Response::sendResponse() {
 
 }
 
-void Response::generateHeaders() {
+void Response::sendBodyBuffer() {
 
-	for (std::map<std::string, std::string>::const_iterator
-			header = mHeaders.begin();
-			header != mHeaders.end(); ++header) {
+	// the body is sent in slices so that the other
+		// clients are handled in between
+	const char* data = mBodyBuffer.getData() + mBodyBufferPos;
+	const size_t size = std::min(mBodyBuffer.getSize()
+		- mBodyBufferPos, mBodyBufferSendSize);
 
-		// RFC format of the header field
-		// HeaderName ":" SP HeaderValue CRLF
-		// first = header name
-		// second = header value
-		// iterates over the headers and adds them to the
-			// send buffer in an http format
-		mBuffer += header->first + ": "
-			+ header->second +"\r\n";
+	// an error response may have no location
+	const bool isZeroCopy = mLocation && mLocation->zerocopy
+		&& mBodyBuffer.getSize() >= mLocation->zerocopyMinSize;
+
+	const ssize_t sentBytes = isZeroCopy
+		? mZeroCopy.send(data, size) : write(mSocket, data, size);
+
+	// the socket is full, so it's tried again
+		// once it's writable
+	if (sentBytes == -1 && isRetryError())
+		return;
 
+	if (sentBytes == -1) {
+		mDone = true;
+		return;
 	}
 
+	mBodyBufferPos += sentBytes;
+
+	// the rest of a streamed listing is still to be generated
+	mIsBodyDone = (mBodyBufferPos == mBodyBuffer.getSize()
+		&& mIsStreamingListing == false);
+
 }
 
-void Response::addHeadersBodySeparator() {
+void Response::readBody() {
+
+	// the body is already in memory
+	if (mBodyBuffer.isEmpty() == false
+		&& mBodyBufferPos < mBodyBuffer.getSize()) {
+
+		const size_t bytesLeft =
+			mBodyBuffer.getSize() - mBodyBufferPos;
+		const size_t readSize =
+			bytesLeft < mReadSize ? bytesLeft : mReadSize;
+
+		const char* data = mBodyBuffer.getData() + mBodyBufferPos;
+		mBodyBufferPos += readSize;
+
+		mIsBodyDone = (mBodyBufferPos == mBodyBuffer.getSize()
+			&& mIsStreamingListing == false);
+
+		// a generated body (like a listing) may need to be
+			// compressed while a cached compressed
+			// body is sent as it is
+		if (mIsCompressing)
+			compressBody(data, readSize);
+		else
+			mBuffer.append(data, readSize);
+
+		return;
+
+	}
+
+	// the rest of a large listing is
+		// generated while it's sent
+	if (mIsStreamingListing) {
+
+		std::string rows;
+
+		try {
+			mIsBodyDone = mAutoIndex.generate(rows, mReadSize);
+		}
+		catch (const std::exception& e) {
+			mDone = true;
+			return;
+		}
 
-	if (mIsSeparator)
-		mBuffer += "\r\n";
+		if (mIsCompressing)
+			compressBody(rows.data(), rows.size());
+		else
+			mBuffer += rows;
+
+		return;
+
+	}
+
+	char bodyBuf[mReadSize];
+
+	// fill bodyBuf from the body file
+	const ssize_t readBytes = pread(mBodyFile->getFd(),
+		bodyBuf, mReadSize, mBodyPos);
+
+	// if reading failed, stops sending the response
+	if (readBytes == -1) {
+		mDone = true;
+		return;
+	}
+
+	mBodyPos += readBytes;
+
+	// a regular file returns less bytes
+		// than requested only at its end
+	mIsBodyDone = (static_cast<size_t>(readBytes) < mReadSize);
+
+	// a huge static file that was fully read leaves the page
+		// cache first so that it doesn't evict hot files
+	if (mIsBodyDone && mBodyFile->getSize() >= mDropCacheMinSize
+		&& (mRequest.getRequestType() == Request::CONTENT
+		|| mRequest.getRequestType() == Request::DEFAULT))
+		mBodyFile->adviseDontNeed();
+
+	if (mIsCompressing) {
+		compressBody(bodyBuf, readBytes);
+		return;
+	}
+
+	// appends the number of read bytes from the file
+		// to the send buffer
+	mBuffer.append(bodyBuf, readBytes);
+
+}
+
+void Response::compressBody(const char* data, const size_t size) {
+
+	const std::string::size_type compressedPos = mBuffer.size();
+
+	mGzipEncoder.compress(data, size, mBuffer);
+
+	if (mIsBodyDone)
+		mGzipEncoder.finish(mBuffer);
+
+	if (mIsCachingBody == false)
+		return;
+
+	mCompressedBody.append(mBuffer, compressedPos,
+		std::string::npos);
+
+	// too large to be cached
+	if (mCompressedBody.size() > GzipCache::getMaxEntrySize()) {
+		mIsCachingBody = false;
+		std::string().swap(mCompressedBody);
+	}
+	else if (mIsBodyDone) {
+		GzipCache::store(mBodyFileName, mLastModified, mBodySize,
+			mLocation->gzipCompLevel, mCompressedBody);
+	}
+
+}
+
+void Response::readRangedBody() {
+
+	// the current range was fully read
+	if (mRangeBytesLeft == 0) {
+
+		// all the ranges were read
+		if (mNextRange == mRangeHandler.getRanges().size()) {
+
+			if (mRangeHandler.isMultipart())
+				mBuffer += mRangeHandler.getClosingDelimiter();
+
+			mIsBodyDone = true;
+			return;
+
+		}
+
+		startNextRange();
+
+	}
+
+	// never reads past the end of the current range
+	const size_t readSize =
+		mRangeBytesLeft < mReadSize ?
+		mRangeBytesLeft : mReadSize;
+
+	// the ranges were checked against the size of the body
+	if (mBodyBuffer.isEmpty() == false) {
+		mBuffer.append(mBodyBuffer.getData() + mBodyPos, readSize);
+		mBodyPos += readSize;
+		mRangeBytesLeft -= readSize;
+		return;
+	}
+
+	char bodyBuf[mReadSize];
+
+	const ssize_t readBytes = pread(mBodyFile->getFd(),
+		bodyBuf, readSize, mBodyPos);
+
+	// the range should be fully available in
+		// the file, otherwise it changed since the
+		// headers were sent or reading failed
+	if (readBytes == -1
+		|| static_cast<size_t>(readBytes) != readSize) {
+		mDone = true;
+		return;
+	}
+
+	mBuffer.append(bodyBuf, readSize);
+	mBodyPos += readSize;
+	mRangeBytesLeft -= readSize;
 
 }
 
+void Response::startNextRange() {
+
+	const RangeHandler::Range& range =
+		mRangeHandler.getRanges()[mNextRange];
+
+	// each range is preceded by its own headers
+		// in a multipart/byteranges body
+	if (mRangeHandler.isMultipart()) {
+		mBuffer += mRangeHandler.getPartHeader
+			(mNextRange, mEntityType);
+	}
+
+	// only the bytes within the range are read
+	mBodyPos = range.first;
+
+	mRangeBytesLeft = range.second - range.first + 1;
+
+	++mNextRange;
+
+}
+
+void Response::generateHeaders() {
+
+	static const std::string connectionClose = "close";
+
+	// computes the size of the header section so
+		// that the buffer is only grown once
+	size_t size = mBuffer.size() + mCGIHeaders.size()
+		+ sizeof("Date: \r\n") + TimeCache::getHttpDate().size()
+		+ sizeof("Server: \r\n") + mServerName.size()
+		+ sizeof("Connection: close\r\n") + sizeof("\r\n");
+
+	for (int field = 0; field < HEADER_FIELDS_COUNT; ++field)
+		if (mHeaders[field].empty() == false)
+			size += std::strlen(mHeaderNames[field])
+				+ mHeaders[field].size() + 4;
+
+	mBuffer.reserve(size);
+
+	// these mandatory headers are always
+		// present in the response message
+	appendHeader("Date", TimeCache::getHttpDate());
+	appendHeader("Server", mServerName);
+	appendHeader("Connection", connectionClose);
+
+	for (int field = 0; field < HEADER_FIELDS_COUNT; ++field)
+		if (mHeaders[field].empty() == false)
+			appendHeader(mHeaderNames[field], mHeaders[field]);
+
+	// fields generated by a CGI script are
+		// already in the http format
+	mBuffer += mCGIHeaders;
+
+}
+
+void Response::appendHeader(const char* name,
+	const std::string& value) {
+
+	// RFC format of the header field
+	// HeaderName ":" SP HeaderValue CRLF
+	mBuffer.append(name);
+	mBuffer.append(": ", 2);
+	mBuffer.append(value);
+	mBuffer.append("\r\n", 2);
+
+}
+
+void Response::addHeadersBodySeparator() {
+	mBuffer += "\r\n";
+}
+
 bool Response::isRedirect() {
 	
 	// the request type is not a redirection
@@ -197,12 +501,27 @@ bool Response::isRedirect() {
     	// to the specified path
 	// the location path is retrieved from the redirection 
 		// directive withing mLocation
-	mHeaders["Location"] = mLocation->redirection.second;
+	mHeaders[LOCATION] = mLocation->redirection.second;
 
 	return true;
 
 }
 
+void Response::setUploadHeaders() {
+
+	if (mRequest.getRequestType() != Request::UPLOAD
+		|| mRequest.getMethod() != Request::PUT)
+		return ;
+
+	const ResumableUpload& upload = mRequest.getResumableUpload();
+
+	mHeaders[RANGE] = upload.getRange();
+
+	if (mStatusCode == StatusCodeHandler::CREATED)
+		mHeaders[LOCATION] = mRequest.getPath();
+
+}
+
 bool Response::isError() {
 
 	// checks that the type of status code
@@ -213,41 +532,39 @@ bool Response::isError() {
 	// clears previous files that contained
 		// unrelated entity bodies
 	mBodyFileName.clear();
+	mBodyFile = NULL;
 
-	// checks if there is a page set to be sent
-		// for that error status code
-	std::map<StatusCode, Path>::const_iterator errorPage
-		= mServer.errorPages.find(mStatusCode);
-	
-	// if an error page is found
-	if (errorPage != mServer.errorPages.end()) {
-
-		const Path& errorPagePath = errorPage->second;
-
-		ConstLocPtr location
-			= mServer.matchLocation(errorPagePath);
-
-		// if the error page matches a location
-			// gets the full path of the page and
-			// sets the file path of the body to it
-		if (location) {
-			
-			// replaces the location prefix by the
-				// root prefix to get the full path
-			mBodyFileName =
-				location->replaceByRoot(errorPagePath);
-
-			// if the error page doesn't exist in the filesystem
-				// returns immediately so that another error
-				// concerning the non-existence of this error
-				// page could be returned
-			if (isPath(mBodyFileName) == false)
-				return true;
+	// caching policies and the validators of the
+		// served file only apply to successful responses
+	// (a cache would revalidate the error body
+		// against the file's entity tag)
+	mHeaders[CACHE_CONTROL].clear();
+	mHeaders[EXPIRES].clear();
+	mHeaders[ETAG].clear();
+	mHeaders[LAST_MODIFIED].clear();
+	mHeaders[ACCEPT_RANGES].clear();
+	mHeaders[VARY].clear();
 
-			setContentType();
-			setContentLength();
+	mBodyBuffer.clear();
+	mBodyBufferPos = 0;
+	mIsStreamingListing = false;
 
-		}
+	// the body of the error was loaded at startup
+		// (from its error_page or generated)
+	const ErrorPages::Page* page
+		= ErrorPages::find(mServer, mStatusCode);
+
+	if (page) {
+
+		mBodyBuffer = page->body;
+
+		if (page->path.empty())
+			mHeaders[CONTENT_TYPE] = "text/html";
+		else
+			setContentType(page->path);
+
+		mBodySize = mBodyBuffer.getSize();
+		mHeaders[CONTENT_LENGTH] = toString(mBodySize);
 
 	}
 
@@ -261,11 +578,79 @@ bool Response::isContent() {
 		!= Request::CONTENT)
 		return false;
 
-	// gets path of the file to be served
+	// gets path of the file to be served which
+		// was already opened by the request
 	mBodyFileName = mRequest.getFullPath();
+	mBodyFile = &mRequest.getFileInfo();
+
+	// static files can be requested partially
+	mHeaders[ACCEPT_RANGES] = "bytes";
+
+	// the file may be replaced by its precompressed sidecar
+	setPrecompressedFile();
 
-	setContentType();
+	setValidators(*mBodyFile, false);
+
+	setCachePolicy(getPathType(mRequest.getFullPath()));
+
+	// the client's copy is still up to date
+	if (isNotModified())
+		return true;
+
+	// the type is always the one of the original file
+	setContentType(mRequest.getFullPath());
 	setContentLength();
+	setRanges();
+
+	return true;
+
+}
+
+bool Response::isAsset() {
+
+	if (mRequest.getRequestType()
+		!= Request::ASSET)
+		return false;
+
+	const AssetPack::Entry& asset = mRequest.getAsset();
+
+	const std::string type(asset.type, asset.typeLength);
+
+	mBodyBuffer = SharedBuffer(asset.data, asset.size);
+	mBodyBufferPos = 0;
+
+	// the gzip variant was compressed when the pack was built
+	if (asset.gzipData && (mLocation->gzipStatic || mLocation->gzip)) {
+
+		// the served representation depends on the
+			// client's Accept-Encoding from now on
+		mHeaders[VARY] = "Accept-Encoding";
+
+		if (isEncodingAccepted("gzip")) {
+			mBodyBuffer = SharedBuffer(asset.gzipData, asset.gzipSize);
+			mHeaders[CONTENT_ENCODING] = "gzip";
+		}
+
+	}
+
+	// files of a pack can be requested partially as well
+	mHeaders[ACCEPT_RANGES] = "bytes";
+
+	// each representation has its own entity tag
+	setValidators(asset.modTime, mBodyBuffer.getSize(), false);
+
+	setCachePolicy(type);
+
+	// the client's copy is still up to date
+	if (isNotModified())
+		return true;
+
+	mHeaders[CONTENT_TYPE] = type;
+
+	mBodySize = mBodyBuffer.getSize();
+	mHeaders[CONTENT_LENGTH] = toString(mBodySize);
+
+	setRanges();
 
 	return true;
 
@@ -293,13 +678,31 @@ bool Response::isDefault() {
 	// set the mBodyFileName to the
 		// full path of the default file
 	mBodyFileName = defaultFileFullPath;
+	mBodyFileInfo.open(mBodyFileName);
+	mBodyFile = &mBodyFileInfo;
+
+	// the file may be replaced by its precompressed sidecar
+	setPrecompressedFile();
+
+	setValidators(*mBodyFile, false);
+
+	setCachePolicy(getPathType(defaultFileFullPath));
+
+	// the client's copy is still up to date
+	if (isNotModified())
+		return true;
 
 	// add the content-type response-header field 
-	setContentType();
+		// of the original default file
+	setContentType(defaultFileFullPath);
 
 	// add the content-lenght response-header field
 	setContentLength();
 
+	// default files can be requested partially as well
+	mHeaders[ACCEPT_RANGES] = "bytes";
+	setRanges();
+
 	return true;
 
 }
@@ -317,54 +720,42 @@ bool Response::isCGI() {
 
 	// cgi script will read the request body
 		// only if there is one
-	if (mRequest.getMethod() == Request::POST) {
-		CGIhandler.setInputFilePath
-			(mRequest.getPathToBodyFileName());
-	}
+	if (mRequest.getMethod() == Request::POST
+		&& mRequest.isBodyInMemory())
+		CGIhandler.setInput(mRequest.getBodyBuffer());
+	else if (mRequest.getMethod() == Request::POST)
+		CGIhandler.setInput(mRequest.getBodyFile());
 
-	// gets the temporary directory where the cgi
-		// output will be stored
-	const std::string& tmpDir =
-		ServerManager::getTmpFilesDir();
+	// the output is kept in memory unless it
+		// grows too large (see CGI)
+	TempFile output;
 
 	try {
 
-		// generates the file path for cgi output
-			// and makes it the path to the entity
-			// body to be sent
-		mBodyFileName = generateFileName(tmpDir);
-		CGIhandler.setOutputFilePath(mBodyFileName);
+		output.create(TempFile::MEMORY);
+		CGIhandler.setOutput(output);
 		CGIhandler.run();
 
-		// gets the size of the output generated by cgi and
-			// makes it the content-length header value of response entity
-		const size_t CGIOutputSize =
-			getFileSize(mBodyFileName);
+		// the body generated by cgi starts after its headers
+		mBodySize = CGIhandler.getContentLength();
+		mBodyOffset = CGIhandler.getBodyOffset();
+
+		mHeaders[CONTENT_LENGTH] = toString(mBodySize);
 
-		mHeaders["content-length"] = toString(CGIOutputSize);
+		setCGIHeaders(CGIhandler.getHeaders());
 
 	}
-	// file name couldn't be generated
+	// the output file couldn't be created
 	// or there was an error in the cgi's output
 	catch (const std::exception& e) {
 		mStatusCode = StatusCodeHandler::SERVER_ERROR;
-		// deletes the temporary file containing the request
-			// body (which is the cgi's input)
-		removeFile(mRequest.getPathToBodyFileName());
 		return true;
 	}
 
-	// do not add a body seprator to the headers since
-		// there is one inclued in the cgi output
-	mIsSeparator = false;
-
-	// deletes the temporary file containing the request
-		// body (which is the cgi's input)
-	removeFile(mRequest.getPathToBodyFileName());
-
-	// deletes the output of the cgi script
-		// after it is sent
-	mIsDelBodyFile = true;
+	// the body is sent from the output's descriptor
+		// and the output is freed once it's closed
+	mBodyFileInfo.adopt(output.release());
+	mBodyFile = &mBodyFileInfo;
 
 	return true;
 
@@ -377,46 +768,96 @@ bool Response::isAutoIndex() {
 		return false;
 	}
 
-	// gets the temporary directory where autoindex
-		// output will be stored
-	const std::string& tmpDir =
-		ServerManager::getTmpFilesDir();
+	// the listing is only validated against the directory's
+		// modification time which doesn't change when an
+		// element within it is modified, so the entity tag
+		// can only be weak
+	setValidators(mRequest.getFileInfo(), true);
+
+	// a page of the listing may be requested
+		// in the query string
+	AutoIndex::PageOptions pageOptions;
+	bool isPage = false;
 
 	try {
+		isPage = AutoIndex::parsePageOptions
+			(mRequest.getQueryString(), pageOptions);
+	}
+	catch (const std::exception& e) {
+		mStatusCode = StatusCodeHandler::BAD_REQUEST;
+		return true;
+	}
 
-		// generates the file path for autoindex output
-			// and makes it the path to the entity
-			// body to be sent
-		mBodyFileName = generateFileName(tmpDir);
+	const char* listingType = (isPage && pageOptions.isJSON)
+		? "application/json" : "text/html";
 
-		// gets the requested directory path so it can be listed
-		const std::string& dirToBeListed = mRequest.getFullPath();
+	setCachePolicy(listingType);
 
-		AutoIndex autoIndexHandler
-			(dirToBeListed, mBodyFileName, mLocation);
+	// the client's copy of the listing is still up to date
+	if (isNotModified())
+		return true;
 
-		autoIndexHandler.generate();
+	const FileInfo& dirInfo = mRequest.getFileInfo();
+	const std::string& dirToBeListed = mRequest.getFullPath();
 
-		// gets the size of the output generated by autoindex and
-			// makes it the content-length header value of response entity
-		const size_t autoIndexOutputSize =
-			getFileSize(mBodyFileName);
+	// each page is cached separately
+	const std::string listingKey = isPage
+		? dirToBeListed + '?' + mRequest.getQueryString()
+		: dirToBeListed;
 
-		mHeaders["content-length"] = toString(autoIndexOutputSize);
+	// the listing is generated again only
+		// if the directory changed
+	if (ListingCache::find(listingKey, mLocation,
+		dirInfo.getModTime(), dirInfo.getSize(),
+		mBodyBuffer) == false) {
+
+		std::string listing;
+
+		try {
+
+			mAutoIndex.open(dirToBeListed, mLocation);
+
+			// a page is bounded by its limit while only
+				// listings that can be cached are fully
+				// generated before they're sent
+			if (isPage)
+				mAutoIndex.generatePage(listing,
+					pageOptions, mRequest.getPath());
+			else
+				mIsStreamingListing = (mAutoIndex.generate(listing,
+					ListingCache::getMaxEntrySize()) == false);
+
+			mBodyBuffer = SharedBuffer(listing);
+
+		}
+		// autoindexing failed
+		catch (const std::exception& e) {
+			mStatusCode = StatusCodeHandler::SERVER_ERROR;
+			return true;
+		}
+
+		// a change made later within the same second wouldn't
+			// change the modification time so the listing
+			// is only kept once that second is over
+		if (mIsStreamingListing == false
+			&& dirInfo.getModTime() < TimeCache::getTime())
+			ListingCache::store(listingKey, mLocation,
+				dirInfo.getModTime(), dirInfo.getSize(),
+				mBodyBuffer);
 
-	}
-	// autoindexing failed
-	catch (const std::exception& e) {
-		mStatusCode = StatusCodeHandler::SERVER_ERROR;
-		return true;
 	}
 
-	// the output generated by autoindex is in html format
-	mHeaders["content-type"] = "text/html";
+	// the output generated by autoindex is in html
+		// format (or json if it was requested)
+	mHeaders[CONTENT_TYPE] = listingType;
 
-	// deletes the output of the autoindex
-		// after it is sent
-	mIsDelBodyFile = true;
+	mBodyBufferPos = 0;
+	mBodySize = mBodyBuffer.getSize();
+
+	// the length of a streamed listing isn't known and
+		// its end is signaled by closing the connection
+	if (mIsStreamingListing == false)
+		mHeaders[CONTENT_LENGTH] = toString(mBodySize);
 
 	return true;
 
@@ -443,24 +884,40 @@ bool Response::isDelete() {
 
 }
 
-void Response::openBodyStream() {
+void Response::openBodyFile() {
 
-	// there is no body to be sent
-	if (mBodyFileName.empty())
+	// there is no body to be sent or it's already in memory
+	if ((mBodyFileName.empty() && mBodyFile == NULL)
+		|| mIsBodyDone || mBodyBuffer.isEmpty() == false)
 		return;
 
-	// if there is already a file associated
-		// with the stream it closes it first
-	if (mBodyStream.is_open())
-		mBodyStream.close();
+	// the file may have already been opened
+		// while the response was generated
+	// (the output of a CGI script has no name)
+	if (mBodyFileName.empty() == false
+		&& (mBodyFile == NULL || mBodyFile->getFd() == -1)) {
+		mBodyFileInfo.open(mBodyFileName);
+		mBodyFile = &mBodyFileInfo;
+	}
+
+	// skips what precedes the entity body
+	mBodyPos = mBodyOffset;
 
-	mBodyStream.open(mBodyFileName.c_str(),
-		std::ofstream::in | std::ofstream::binary);
+	// file was opened succesfully
+	if (mBodyFile->getFd() != -1) {
+
+		// a large body that's read from start to end
+			// is read ahead by the kernel
+		if (mBodyFile->getSize() >= mReadAheadMinSize
+			&& mRangeHandler.getRanges().empty()) {
+			mBodyFile->adviseSequential();
+			mBodyFile->adviseWillNeed(mBodyPos, mReadAheadSize);
+		}
 
-	// stream was opened succesfully
-	if (mBodyStream)
 		return ;
 
+	}
+
 	// otherwise clears the bodyfilename and
 		// removes the headers that are associated
 		// with the entity body
@@ -470,49 +927,505 @@ void Response::openBodyStream() {
 
 }
 
-void Response::setContentType() {
-	
-	// search for mBodyFileName extension pos
+void Response::setCGIHeaders(const std::string& headers) {
+
+	std::string::size_type lineBegin = 0;
+	while (lineBegin < headers.size()) {
+
+		std::string::size_type lineEnd =
+			headers.find("\r\n", lineBegin);
+		if (lineEnd == std::string::npos)
+			lineEnd = headers.size();
+
+		const std::string line =
+			headers.substr(lineBegin, lineEnd - lineBegin);
+
+		lineBegin = lineEnd + 2;
+
+		if (line.empty())
+			continue;
+
+		const std::string::size_type colonPos = line.find(':');
+
+		std::string name = line.substr(0, colonPos);
+		for (std::string::size_type i = 0; i < name.size(); ++i)
+			name[i] = std::tolower(name[i]);
+
+		if (name == "content-length")
+			continue;
+
+		// the content type is needed to decide whether
+			// the body can be compressed
+		if (name == "content-type" && colonPos != std::string::npos)
+			mHeaders[CONTENT_TYPE] =
+				trimWhiteSpace(line.substr(colonPos + 1));
+		else
+			mCGIHeaders += line + "\r\n";
+
+	}
+
+}
+
+void Response::setContentType(const std::string& path) {
+
+	// add the content-type response-header field
+		// with the associated file type of path
+	mHeaders[CONTENT_TYPE] = getPathType(path);
+
+}
+
+const Response::Mimetype& Response::getPathType
+	(const std::string& path) const {
+
+	// search for path extension pos
 	const std::string::size_type& extentionPos
-		= mBodyFileName.rfind(".");
+		= path.rfind(".");
 	
-	// sets the mbodyFileName extension if found
+	// sets the path extension if found
 		// starting from the pos after
 		// the extension dot
 	// if not found the bodyFileExtension
 		// will be left empty
 	const Extension& bodyFileExtension 
 		= extentionPos != std::string::npos ?
-		mBodyFileName.substr(extentionPos + 1) : "";
+		path.substr(extentionPos + 1) : "";
 
 	// get the mime type associated to
 		// the bodyFileExtension in mMimeTypes
 	// if not found, get the default
 		// mime type (application/octet-stream)
-	const Mimetype& fileMimeType 
-		= mMimeTypes.getType(bodyFileExtension);
+	return mMimeTypes.getType(bodyFileExtension);
 
-	// add the content-type response-header field
-		// with the associated file type of mBodyFileName
-	mHeaders["Content-Type"] = fileMimeType;
+}
+
+void Response::setCachePolicy(const std::string& type) {
+
+	if (mStatusCode != StatusCodeHandler::OK)
+		return;
+
+	long expires = mLocation->expires;
+
+	// the expiry of the type overrides the one of the location
+	const std::map<std::string, long>::const_iterator typeExpires
+		= mLocation->expiresTypes.find(type);
+	if (typeExpires != mLocation->expiresTypes.end())
+		expires = typeExpires->second;
+
+	std::string cacheControl;
+
+	// a response that mustn't be stored has no freshness lifetime
+	if (expires >= 0 && mLocation->cacheControl.find("no-store")
+		== std::string::npos) {
+
+		mHeaders[EXPIRES] = timeToHttpDate(TimeCache::getTime() + expires);
+		cacheControl = "max-age=" + toString(expires);
+
+	}
+
+	if (mLocation->cacheControl.empty() == false) {
+
+		if (cacheControl.empty() == false)
+			cacheControl += ", ";
+
+		cacheControl += mLocation->cacheControl;
+
+	}
+
+	if (cacheControl.empty() == false)
+		mHeaders[CACHE_CONTROL] = cacheControl;
+
+}
+
+void Response::setPrecompressedFile() {
+
+	if (mLocation->gzipStatic == false)
+		return;
+
+	// the served representation depends on the
+		// client's Accept-Encoding from now on
+	mHeaders[VARY] = "Accept-Encoding";
+
+	// content-codings in order of preference
+		// and the extensions of their sidecars
+	const char* codings[][2] = {
+		{"br", ".br"},
+		{"gzip", ".gz"}
+	};
+
+	if (mBodyFile->isPath() == false)
+		return;
+
+	const std::time_t modTime = mBodyFile->getModTime();
+
+	FileInfo sidecarInfo;
+
+	for (size_t i = 0; i < sizeof(codings) / sizeof(codings[0]); ++i) {
+
+		if (isEncodingAccepted(codings[i][0]) == false)
+			continue;
+
+		const std::string sidecar = mBodyFileName + codings[i][1];
+
+		// the sidecar should be a regular file that's
+			// at least as recent as the original one,
+			// otherwise it's stale
+		if (sidecarInfo.open(sidecar) == false
+			|| sidecarInfo.isRegular() == false
+			|| sidecarInfo.getModTime() < modTime)
+			continue;
+
+		// the sidecar is served from
+			// the descriptor it was opened with
+		mBodyFileInfo.swap(sidecarInfo);
+		mBodyFile = &mBodyFileInfo;
+
+		mBodyFileName = sidecar;
+		mHeaders[CONTENT_ENCODING] = codings[i][0];
+		return;
+
+	}
+
+}
+
+void Response::setCompression() {
+
+	// only full successful responses are compressed
+		// and sidecars are already compressed
+	if (mStatusCode != StatusCodeHandler::OK
+		|| (mBodyFileName.empty() && mBodyFile == NULL
+			&& mBodyBuffer.isEmpty())
+		|| mLocation == NULL
+		|| mLocation->gzip == false
+		|| mHeaders[CONTENT_ENCODING].empty() == false)
+		return;
+
+	const std::string& contentType = mHeaders[CONTENT_TYPE];
+
+	if (contentType.empty())
+		return;
+
+	// the parameters of the type (like charset) are ignored
+	std::string type = trimWhiteSpace(contentType.substr
+		(0, contentType.find(';')));
+	for (std::string::size_type i = 0; i < type.size(); ++i)
+		type[i] = std::tolower(type[i]);
+
+	if (mLocation->gzipTypes.count(type) == 0
+		|| mBodySize < mLocation->gzipMinLength)
+		return;
+
+	// the served representation depends on the
+		// client's Accept-Encoding from now on
+	mHeaders[VARY] = "Accept-Encoding";
+
+	if (isEncodingAccepted("gzip") == false)
+		return;
+
+	mHeaders[CONTENT_ENCODING] = "gzip";
+
+	// the compressed length isn't known before the body is
+		// compressed and the compressed representation
+		// can't be requested partially
+	mHeaders[CONTENT_LENGTH].clear();
+	mHeaders[ACCEPT_RANGES].clear();
+
+	// the compressed bytes aren't guaranteed to be the
+		// same for the same entity so the tag becomes weak
+	if (mETag.empty() == false && mETag.compare(0, 2, "W/")) {
+		mETag.insert(0, "W/");
+		mHeaders[ETAG] = mETag;
+	}
+
+	const Request::RequestType requestType =
+		mRequest.getRequestType();
+
+	// only static files are cached since the bodies
+		// of the other responses are generated
+	if (requestType == Request::CONTENT
+		|| requestType == Request::DEFAULT) {
+
+		if (GzipCache::find(mBodyFileName, mLastModified,
+			mBodySize, mLocation->gzipCompLevel, mBodyBuffer)) {
+
+			// the compressed length is known when it's cached
+			mHeaders[CONTENT_LENGTH] =
+				toString(mBodyBuffer.getSize());
+			return;
+
+		}
+
+		mIsCachingBody =
+			(mBodySize <= GzipCache::getMaxEntrySize());
+
+	}
+
+	mGzipEncoder.start(mLocation->gzipCompLevel);
+	mIsCompressing = true;
+
+}
+
+bool Response::isEncodingAccepted(const std::string& coding) const {
+
+	const std::string* acceptEncoding =
+		mRequest.getHeaderValue("accept-encoding");
+
+	if (acceptEncoding == NULL)
+		return false;
+
+	// qualities of the coding and of the
+		// wildcard (-1 if they're not listed)
+	double codingQuality = -1;
+	double wildcardQuality = -1;
+
+	std::string::size_type elementBegin = 0;
+	while (elementBegin < acceptEncoding->size()) {
+
+		std::string::size_type elementEnd =
+			acceptEncoding->find(',', elementBegin);
+		if (elementEnd == std::string::npos)
+			elementEnd = acceptEncoding->size();
+
+		const std::string element = acceptEncoding->substr
+			(elementBegin, elementEnd - elementBegin);
+
+		// the coding name may be followed by its quality (;q=value)
+		const std::string::size_type paramsPos = element.find(';');
+
+		std::string name = trimWhiteSpace(element.substr(0, paramsPos));
+		for (std::string::size_type i = 0; i < name.size(); ++i)
+			name[i] = std::tolower(name[i]);
+
+		double quality = 1;
+		if (paramsPos != std::string::npos) {
+
+			const std::string::size_type qualityPos =
+				element.find("q=", paramsPos);
+
+			if (qualityPos != std::string::npos) {
+				quality = std::strtod
+					(element.c_str() + qualityPos + 2, NULL);
+			}
+
+		}
+
+		if (name == coding)
+			codingQuality = quality;
+		else if (name == "*")
+			wildcardQuality = quality;
+
+		elementBegin = elementEnd + 1;
+
+	}
+
+	if (codingQuality >= 0)
+		return (codingQuality > 0);
+
+	return (wildcardQuality > 0);
 
 }
 
 void Response::setContentLength() {
 
-	try {
+	// gets the size of the file containing
+		// the response body
+	mBodySize = mBodyFile->getSize();
+	mHeaders[CONTENT_LENGTH] = toString(mBodySize);
+
+}
+
+void Response::setRanges() {
+
+	const std::string* range =
+		mRequest.getHeaderValue("range");
+
+	// ranges only apply to successful GET requests
+	if (range == NULL || mStatusCode != StatusCodeHandler::OK
+		|| mRequest.getMethod() != Request::GET
+		|| isIfRangeMatch() == false)
+		return;
+
+	switch (mRangeHandler.parse(*range, mBodySize)) {
+
+		// the full body is served
+		case RangeHandler::NONE:
+			return;
+
+		// none of the ranges overlap the body
+		case RangeHandler::UNSATISFIABLE:
+			clearEntityBodyData();
+			mStatusCode = StatusCodeHandler::RANGE_NOT_SATISFIABLE;
+			mHeaders[CONTENT_RANGE] =
+				mRangeHandler.getUnsatisfiedContentRange();
+			return;
+
+		case RangeHandler::SATISFIABLE:
+			break;
+
+	}
+
+	mStatusCode = StatusCodeHandler::PARTIAL_CONTENT;
+
+	mEntityType = mHeaders[CONTENT_TYPE];
 
-		// gets the size of the file containing
-			// the response body
-		const size_t bodyFileSize
-			= getFileSize(mBodyFileName);
-		mHeaders["Content-Length"] = toString(bodyFileSize);
+	mHeaders[CONTENT_LENGTH] =
+		toString(mRangeHandler.getBodyLength(mEntityType));
 
+	// each part carries its own content-type and
+		// content-range in a multipart/byteranges body
+	if (mRangeHandler.isMultipart())
+		mHeaders[CONTENT_TYPE] = mRangeHandler.getMultipartType();
+	else
+		mHeaders[CONTENT_RANGE] = mRangeHandler.getContentRange(0);
+
+}
+
+bool Response::isIfRangeMatch() {
+
+	const std::string* ifRange =
+		mRequest.getHeaderValue("if-range");
+
+	if (ifRange == NULL)
+		return true;
+
+	// the validator is an entity tag that
+		// has to strongly match the entity's
+	if (ifRange->compare(0, 1, "\"") == 0
+		|| ifRange->compare(0, 2, "W/") == 0) {
+		return isETagMatch(*ifRange, true);
+	}
+
+	// the validator is an http-date that has to be exactly
+		// the last modification date of the entity
+	try {
+		return (httpDateToTime(*ifRange) == mLastModified);
 	}
 	catch (const std::exception& e) {
+		return false;
+	}
+
+}
+
+void Response::setValidators(const FileInfo& file,
+	const bool isWeak) {
+
+	if (file.isPath() == false) {
 		mStatusCode = StatusCodeHandler::SERVER_ERROR;
+		return;
+	}
+
+	setValidators(file.getModTime(), file.getSize(), isWeak);
+
+}
+
+void Response::setValidators(const std::time_t modTime,
+	const size_t size, const bool isWeak) {
+
+	mLastModified = modTime;
+
+	// the entity tag is made of the modification time
+		// and the size so it changes whenever one of them does
+	mETag = std::string(isWeak ? "W/" : "") + '"'
+		+ decimalToHex(modTime) + '-'
+		+ decimalToHex(size) + '"';
+
+	mHeaders[ETAG] = mETag;
+	mHeaders[LAST_MODIFIED] = timeToHttpDate(mLastModified);
+
+}
+
+bool Response::isNotModified() {
+
+	// conditions only apply to successful GET requests
+	if (mStatusCode != StatusCodeHandler::OK
+		|| mRequest.getMethod() != Request::GET)
+		return false;
+
+	const std::string* ifNoneMatch =
+		mRequest.getHeaderValue("if-none-match");
+	const std::string* ifModifiedSince =
+		mRequest.getHeaderValue("if-modified-since");
+
+	bool isNotModified = false;
+
+	// If-Modified-Since is ignored when
+		// If-None-Match is present
+	if (ifNoneMatch)
+		isNotModified = isETagMatch(*ifNoneMatch, false);
+	else if (ifModifiedSince) {
+		try {
+			isNotModified = (mLastModified
+				<= httpDateToTime(*ifModifiedSince));
+		}
+		// invalid dates are ignored
+		catch (const std::exception& e) {}
+	}
+
+	if (isNotModified == false)
+		return false;
+
+	mStatusCode = StatusCodeHandler::NOT_MODIFIED;
+
+	// a 304 response has no entity body
+	mIsBodyDone = true;
+	mHeaders[CONTENT_TYPE].clear();
+	mHeaders[CONTENT_LENGTH].clear();
+
+	return true;
+
+}
+
+bool Response::isETagMatch(const std::string& list,
+	const bool isStrong) const {
+
+	// the wildcard matches any current entity
+	if (list == "*")
+		return true;
+
+	const bool isWeakETag = (mETag.compare(0, 2, "W/") == 0);
+
+	// a weak entity tag never matches in a strong comparison
+	if (isStrong && isWeakETag)
+		return false;
+
+	// opaque part of the entity tag (without the weak prefix)
+	const std::string opaqueETag =
+		isWeakETag ? mETag.substr(2) : mETag;
+
+	std::string::size_type tagBegin = 0;
+	while (tagBegin < list.size()) {
+
+		std::string::size_type tagEnd = list.find(',', tagBegin);
+		if (tagEnd == std::string::npos)
+			tagEnd = list.size();
+
+		// removes the white space around the entity tag
+		const std::string::size_type first =
+			list.find_first_not_of(" \t", tagBegin);
+		const std::string::size_type last =
+			list.find_last_not_of(" \t", tagEnd - 1);
+
+		if (first != std::string::npos && first < tagEnd
+			&& last != std::string::npos && last >= first) {
+
+			std::string tag = list.substr(first, last - first + 1);
+
+			const bool isWeakTag = (tag.compare(0, 2, "W/") == 0);
+
+			if (isWeakTag)
+				tag.erase(0, 2);
+
+			if ((isStrong == false || isWeakTag == false)
+				&& tag == opaqueETag)
+				return true;
+
+		}
+
+		tagBegin = tagEnd + 1;
+
 	}
 
+	return false;
+
 }
 
 void Response::generateStatusLine() {
@@ -522,33 +1435,45 @@ void Response::generateStatusLine() {
 		// the string format of mStatuscode
 	// the second element is the reason phrase 
 		// associated to mStatusCode
-	const StatusCodeHandler::StatusCodePair 
+	const StatusCodeHandler::StatusCodePair& 
 		statusCodePair = StatusCodeHandler::
 		getStatusCodeInfo(mStatusCode);
 	
-	// construct the response status line
-		// that has the format:
+	// appends the response status line to mBuffer
+		// which has the format:
 		// [HTTP-Version SP Status-Code SP Reason-Phrase CRLF]
-	const std::string statusLine 
-		// the http version including the first space
-		= "HTTP/1.1 "
-		// string format of mStatusCode
-		+ statusCodePair.first
-		+ " "
-		// textual reason phrase
-		+ statusCodePair.second
-		+ "\r\n";
-
-	// add the response status line to mBuffer
-	mBuffer.append(statusLine);
+	// the http version including the first space
+	mBuffer.append("HTTP/1.1 ", 9);
+	// string format of mStatusCode
+	mBuffer.append(statusCodePair.first);
+	mBuffer += ' ';
+	// textual reason phrase
+	mBuffer.append(statusCodePair.second);
+	mBuffer.append("\r\n", 2);
 
 }
 
 void Response::clearEntityBodyData() {
 
 	mBodyFileName.clear();
-	mHeaders.erase("Content-Type");
-	mHeaders.erase("Content-Length");
+	mBodyFile = NULL;
+	mHeaders[CONTENT_TYPE].clear();
+	mHeaders[CONTENT_LENGTH].clear();
+	mHeaders[CONTENT_RANGE].clear();
+	mHeaders[CONTENT_ENCODING].clear();
+	mHeaders[CACHE_CONTROL].clear();
+	mHeaders[EXPIRES].clear();
+	mHeaders[ETAG].clear();
+	mHeaders[LAST_MODIFIED].clear();
+	mHeaders[ACCEPT_RANGES].clear();
+	mHeaders[VARY].clear();
+	mRangeHandler.clear();
+	mIsCompressing = false;
+	mIsCachingBody = false;
+	mBodyBuffer.clear();
+	mIsStreamingListing = false;
+	mBodyOffset = 0;
+	mCGIHeaders.clear();
 
 }
 
@@ -571,12 +1496,22 @@ void Response::logResponse() {
 
 	// an error response
 	if (mStatusCode >= 400) {
-		if (mBodyFileName.empty())
+
+		const ErrorPages::Page* page
+			= ErrorPages::find(mServer, mStatusCode);
+
+		if (page == NULL)
 			operation = "error with no page";
+		else if (page->path.empty())
+			operation = "error with the default page";
 		else {
 			operation += "error containing page '"
-			+ mBodyFileName + '\''; 
+			+ page->path + '\''; 
 		}
+
+	}
+	else if (mStatusCode == StatusCodeHandler::NOT_MODIFIED) {
+		operation = "entity not modified: ";
 	}
 	else if (requestType == Request::REDIRECT) {
 		operation = "redirection to the URL: '";
@@ -590,6 +1525,34 @@ void Response::logResponse() {
 		|| requestType == Request::CONTENT) {
 		operation = "served file: ";
 	}
+	else if (requestType == Request::ASSET) {
+		operation = "served from asset pack '";
+		operation += mLocation->assetPack;
+		operation += "': '";
+		operation += mRequest.getPath();
+		operation += '\'';
+	}
+	else if (requestType == Request::UPLOAD
+		&& method == Request::PUT) {
+
+		const ResumableUpload& upload = mRequest.getResumableUpload();
+
+		operation = "received " + upload.getContentRange()
+			+ " of '" + upload.getPath() + '\'';
+
+	}
+	else if (requestType == Request::UPLOAD
+		&& mRequest.getPathToBodyFileName().empty()) {
+
+		operation = "multipart upload of files:";
+
+		const std::vector<std::string>& files
+			= mRequest.getUploadedFiles();
+		for (std::vector<std::string>::const_iterator file
+			= files.begin(); file != files.end(); ++file)
+			operation += " '" + *file + '\'';
+
+	}
 	else if (requestType == Request::UPLOAD) {
 		operation = "file uploaded to: '";
 		operation += mRequest.getPathToBodyFileName();
@@ -626,6 +1589,10 @@ void Response::logResponse() {
 
 	}
 
+	const std::string zeroCopyReport = mZeroCopy.getReport();
+	if (zeroCopyReport.empty() == false)
+		operation += " (" + zeroCopyReport + ')';
+
 	operation.insert(0, statusCode + ", ");
 
 	Log::response(mSocket, operation);
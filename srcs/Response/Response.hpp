@@ -9,11 +9,23 @@
 #include <StatusCodeHandler.hpp>
 #include <Config.hpp>
 #include <stdexcept>
+#include <algorithm>
+#include <cstdlib>
+#include <cctype>
 #include <unistd.h>
 #include <utils.hpp>
 #include <MimeTypes.hpp>
 #include <Log.hpp>
 #include <AutoIndex.hpp>
+#include <ListingCache.hpp>
+#include <RangeHandler.hpp>
+#include <GzipEncoder.hpp>
+#include <GzipCache.hpp>
+#include <SharedBuffer.hpp>
+#include <FileInfo.hpp>
+#include <ErrorPages.hpp>
+#include <TimeCache.hpp>
+#include <ZeroCopySender.hpp>
 
 // forward declaration of request
 // it's included at the bottom of the file
@@ -42,16 +54,24 @@ class Response {
 		Response(Socket socket, const Request& request,
 			ConstServerRef server, const MimeTypes& mimeTypes);
 
-		~Response();
-
 		// returns true if it still wants to write
 			// response bytes on the socket
 		// returns false if fully done sending
 			// the response
 		bool isWrite() const ;
 
+		// returns true once the whole response is sent
+			// while the kernel may still use the body
+			// bytes that were sent without being copied,
+			// or while a zero-copy send is deferred until
+			// the previous ones complete
+		// the socket becomes readable when it's done
+		bool isRead() const;
+
 		// signals that the socket is ready for writing
 			// attempts to send response bytes over socket
+		// when reading, handles the notifications of
+			// the kernel about the zero-copy sends
 		void proceedWithSocket();
 
 		// starts the reponse generating process
@@ -67,6 +87,25 @@ class Response {
 		const MimeTypes& getMimeTypes() const;
 	
 	private:
+		/******* private nested types *******/
+		// response header fields that can be set
+			// (in the order they are sent)
+		enum HeaderField {
+			ACCEPT_RANGES,
+			CACHE_CONTROL,
+			CONTENT_ENCODING,
+			CONTENT_LENGTH,
+			CONTENT_RANGE,
+			CONTENT_TYPE,
+			ETAG,
+			EXPIRES,
+			LAST_MODIFIED,
+			LOCATION,
+			RANGE,
+			VARY,
+			HEADER_FIELDS_COUNT
+		};
+
 		/******* private member objects *******/
 		// socket over which the
 			// reponse will be sent
@@ -104,42 +143,147 @@ class Response {
 
 		// file where the body to be sent is stored
 			// if the response will send one
-		// if mIsDelBodyFile is set, this file will
-			// be removed
+		// it's empty for the output of a CGI script
+			// which is only known by its descriptor
 		std::string mBodyFileName;
 
-		// the file stream where the response body is
-			// stored will be turned into a
-			// file stream before sending it
-		std::ifstream mBodyStream;
-
-		// response headers
-		// connection: close header pair is always present
-		std::map<std::string, std::string> mHeaders;
-
-		// stores if the headers-body separator is needed
-		// by default, there is a body separator unless
-			// it is provided by another response type
-			// like CGI
-		bool mIsSeparator;
-
-		// stores whether the file containing the sent
-			// body should be deleted
-		// it's deleted in the destructor
-		bool mIsDelBodyFile;
+		// descriptor and metadata of mBodyFileName
+		// it points either to the file resolved by the
+			// request (so it isn't opened again) or
+			// to mBodyFileInfo
+		// NULL if mBodyFileName wasn't opened yet
+		const FileInfo* mBodyFile;
+
+		// files opened by the response itself (default
+			// file, sidecar, CGI output)
+		FileInfo mBodyFileInfo;
+
+		// position in mBodyFile of the next
+			// body byte that will be read
+		off_t mBodyPos;
+
+		// set when all the body bytes were read
+			// from mBodyFile
+		bool mIsBodyDone;
+
+		// size of the file containing the entity
+			// body (set by setContentLength())
+		size_t mBodySize;
+
+		// parses the Range request-header field and holds
+			// the byte ranges of the body to be sent
+		// if it has no ranges, the full body is sent
+		RangeHandler mRangeHandler;
+
+		// entity tag of the served entity
+			// (set by setValidators())
+		std::string mETag;
+
+		// last modification time of the served
+			// entity (set by setValidators())
+		std::time_t mLastModified;
+
+		// content type of the served entity
+		// it's used in the headers of the parts of a
+			// multipart/byteranges body
+		std::string mEntityType;
+
+		// index of the next range whose bytes
+			// will be read from mBodyFile
+		size_t mNextRange;
+
+		// bytes of the current range that still
+			// need to be read from mBodyFile
+		size_t mRangeBytesLeft;
+
+		// compresses the entity body while it's read
+			// from mBodyFile if mIsCompressing is set
+		GzipEncoder mGzipEncoder;
+
+		// set when the entity body is sent
+			// compressed with gzip
+		bool mIsCompressing;
+
+		// set when the compressed body of a static file
+			// is collected in mCompressedBody so that it's
+			// stored in GzipCache once it's fully read
+		bool mIsCachingBody;
+
+		// compressed body collected for GzipCache
+		std::string mCompressedBody;
+
+		// entity body that's already in memory (like a
+			// cached compressed file)
+		// if it's not empty, it's sent instead
+			// of the content of mBodyFile
+		SharedBuffer mBodyBuffer;
+
+		// number of bytes of mBodyBuffer
+			// that were already read
+		size_t mBodyBufferPos;
+
+		// sends a large mBodyBuffer without copying it
+			// (see sendBodyBuffer())
+		ZeroCopySender mZeroCopy;
+
+		// position of the first entity body byte
+			// in mBodyFile
+		// (the output of a CGI script starts
+			// with its headers)
+		size_t mBodyOffset;
+
+		// generates the listing of an autoindex request
+		AutoIndex mAutoIndex;
+
+		// set when a listing too large to be cached is
+			// generated while it's sent (its first part
+			// is in mBodyBuffer)
+		bool mIsStreamingListing;
+
+		// header fields generated by a CGI script that
+			// are sent after the ones of mHeaders
+		// (each field ends with a CRLF)
+		std::string mCGIHeaders;
+
+		// values of the response headers indexed by
+			// HeaderField (a header isn't sent if its
+			// value is empty)
+		// Date, Server and Connection: close are
+			// always sent before them
+		std::string mHeaders[HEADER_FIELDS_COUNT];
 
 		// contains the types needed for content-type
 		const MimeTypes& mMimeTypes;
 
+		// names of the header fields indexed by HeaderField
+		const static char* const mHeaderNames[HEADER_FIELDS_COUNT];
+
+		// value of the Server header field
+		const static std::string mServerName;
+
 		// amount of bytes sent on each send attempt
 		const static size_t mSendSize;
 
+		// maximum amount of bytes of mBodyBuffer
+			// sent on each send attempt
+		const static size_t mBodyBufferSendSize;
+
 		// amount of bytes read from the body stream
 			// on each attempt
 		// these are the bytes that are sent in the
 			// response body message
 		const static size_t mReadSize;
 
+		// minimum size of a body file whose reading is
+			// hinted as sequential to the kernel, and amount
+			// of bytes that are read ahead when it's opened
+		const static size_t mReadAheadMinSize;
+		const static size_t mReadAheadSize;
+
+		// minimum size of a static file whose pages are
+			// dropped from the page cache once it's sent
+		const static size_t mDropCacheMinSize;
+
 		/******* private member functions *******/
 		// contains the main logic that generates
 			// the reponse
@@ -149,24 +293,72 @@ class Response {
 			// socket
 		void sendResponse();
 
+		// writes the bytes of mBodyBuffer that weren't sent yet
+			// straight from its storage to the socket
+		// it's used once the header section was sent when the
+			// in-memory body is sent as it is (not compressed
+			// nor split in ranges)
+		// when the location's zerocopy is on, a body of at least
+			// zerocopyMinSize bytes is sent with mZeroCopy, so
+			// mBodyBuffer is kept (and the response isn't done)
+			// until the kernel is done with it
+		void sendBodyBuffer();
+
+		// reads the next bytes of the full body from
+			// mBodyFile (or mBodyBuffer if the body is in
+			// memory, or mAutoIndex if the listing is
+			// streamed) and appends them to mBuffer
+		// the bytes are compressed first if
+			// mIsCompressing is set
+		// sets mDone if reading fails
+		void readBody();
+
+		// compresses size bytes of data and appends the
+			// compressed bytes to mBuffer
+		// the compression is finished if mIsBodyDone is set
+			// and the compressed body is stored in GzipCache
+			// if mIsCachingBody is set
+		void compressBody(const char* data, const size_t size);
+
+		// same as above but only reads the bytes that
+			// belong to the ranges of mRangeHandler
+		// they're taken from mBodyBuffer if the
+			// body is in memory
+		// the multipart/byteranges framing is also
+			// appended to mBuffer if there is more
+			// than one range
+		void readRangedBody();
+
+		// moves mBodyPos to the first byte of the next
+			// range and appends its part header to
+			// mBuffer in the multipart case
+		void startNextRange();
+
 		// appends the approriate status line
 			// to the sending buffer
 		void generateStatusLine();
 
 		// appends the appropriate headers
 			// to the sending buffer
+		// the header section is written directly
+			// into the buffer after reserving its size
 		void generateHeaders();
 
-		// appends a CRLF separator to the sending
-		// buffer if needed (if mIsSeparator is set)
+		// appends the header field name with value
+			// to the sending buffer
+		void appendHeader(const char* name,
+			const std::string& value);
+
+		// appends a CRLF separator to the sending buffer
 		void addHeadersBodySeparator();
 
-		// if the response requires a body, opens the stream
-			// of the file where the message body exists
+		// if the response requires a body and mBodyFile wasn't
+			// opened yet, opens the file where the message body
+			// exists and sets the position of its first byte
 		// sets status code to an error code and calls
 			// clearEntityBodyData() if the file
 			// couldn't be opened
-		void openBodyStream();
+		void openBodyFile();
 
 		/* these functions check the type of response to be made,
 		 *  generare it and set its headers in the headers members
@@ -175,16 +367,27 @@ class Response {
 		 * Errors may happen during these functions so in that case
 		 *  the status code is set accordingly
 		 */
-		// checks if the reponse contains an error status and looks
-			// for the error entity to be sent if there is one
+		// checks if the reponse contains an error status and takes
+			// the in-memory error entity to be sent from ErrorPages
 		bool isError();
 
 		// sets the location header
 		bool isRedirect();
 
+		// tells the client of a PUT upload which bytes were
+			// received (Range header) and where the file is
+			// once it's complete (Location header)
+		void setUploadHeaders();
+
 		// checks if the response will serve a regular file
 		bool isContent();
 
+		// checks if the response will serve a file of an asset
+			// pack whose body is sent from the pack's mapping
+		// its gzip variant is served instead when the location
+			// enables gzip_static or gzip and the client accepts it
+		bool isAsset();
+
 		// checks if the response will serve a default file
 			// which is located in the location
 			// config of the requested path (mLocation)
@@ -202,13 +405,103 @@ class Response {
 		bool isDelete();
 
 		// sets content length header of the entity body to
-			// be sent
+			// be sent from the size of mBodyFile
 		void setContentLength();
 
-		// search the mime type associated to mBodyFileName
-			// and add the content-type response-header field
-			// with the retrieved type to mHeaders
-		void setContentType();
+		// checks the Range request-header field of a GET request
+			// and restricts the entity body to its ranges
+		// sets the status code to 206 and the headers that
+			// describe the ranges if they can be served, or to
+			// 416 if none of them is satisfiable
+		// it has no effect if the ranges are invalid or the
+			// If-Range precondition isn't met
+		// should be called after setContentType()
+			// and setContentLength()
+		void setRanges();
+
+		// returns true if there is no If-Range request-header
+			// field or if its validator matches the entity
+		bool isIfRangeMatch();
+
+		// generates the ETag and Last-Modified headers of
+			// the entity from the modification time and
+			// size of file
+		// a weak entity tag is generated if isWeak is set
+		// sets status code to an error code if
+			// file doesn't exist
+		void setValidators(const FileInfo& file,
+			const bool isWeak);
+
+		// same as above for an entity whose modification
+			// time and size are known
+		void setValidators(const std::time_t modTime,
+			const size_t size, const bool isWeak);
+
+		// evaluates the If-None-Match and If-Modified-Since
+			// request-header fields of a GET request against
+			// the validators set by setValidators()
+		// returns true and sets the status code to 304 if the
+			// client's cached copy is still valid, in which
+			// case no entity body is sent
+		bool isNotModified();
+
+		// returns true if one of the entity tags in the
+			// comma separated list matches mETag
+			// or the list is "*"
+		// weak comparison is used unless isStrong is set
+			// (in that case weak tags never match)
+		bool isETagMatch(const std::string& list,
+			const bool isStrong) const;
+
+		// splits the header section generated by a CGI script
+			// into the content-type header of mHeaders and the
+			// other fields that are kept in mCGIHeaders
+		// the content-length field is dropped since the
+			// server sets its own
+		void setCGIHeaders(const std::string& headers);
+
+		// search the mime type associated to the extension
+			// of path and add the content-type response-header
+			// field with the retrieved type to mHeaders
+		void setContentType(const std::string& path);
+
+		// returns the mime type associated to the extension
+			// of path (or the default one if there is none)
+		const Mimetype& getPathType(const std::string& path) const;
+
+		// sets the Expires and Cache-Control headers of a
+			// successful response according to the expires,
+			// expires_type and cache_control directives of
+			// mLocation
+		// type is the mime type of the served entity which
+			// selects its expires_type if there is one
+		// should be called before isNotModified() since a
+			// 304 response carries the same caching headers
+		void setCachePolicy(const std::string& type);
+
+		// if the location enables gzip_static, looks for a
+			// precompressed sidecar of mBodyFileName (file.br or
+			// file.gz) whose encoding is accepted by the client
+			// and that's not older than mBodyFileName
+		// if one is found, it becomes mBodyFileName and the
+			// content-encoding header is set
+		void setPrecompressedFile();
+
+		// if the location enables gzip and the type and length
+			// of the entity body allow it, makes the body be
+			// compressed with gzip when the client accepts it
+		// the compressed body of a static file is taken from
+			// GzipCache if it was already compressed
+		// only 200 responses are compressed so ranges and
+			// precompressed sidecars take precedence
+		// should be called once the response type was
+			// determined and its headers were set
+		void setCompression();
+
+		// returns true if the Accept-Encoding request-header
+			// field allows the content-coding to be used
+			// (listed or matched by '*' with a non-zero quality)
+		bool isEncodingAccepted(const std::string& coding) const;
 
 		// clears the file name and headers associated
 			// with the entity body
@@ -8,9 +8,15 @@ void StatusCodeHandler::initializeStaticData() {
 	
 	StatusCodePair statusCodePair("200", "OK");
 	mStatusCodesData[OK] = statusCodePair;
+
+	statusCodePair = std::make_pair("201", "Created");
+	mStatusCodesData[CREATED] = statusCodePair;
 	
 	statusCodePair = std::make_pair("204", "No Content");
 	mStatusCodesData[NO_CONTENT] = statusCodePair;
+
+	statusCodePair = std::make_pair("206", "Partial Content");
+	mStatusCodesData[PARTIAL_CONTENT] = statusCodePair;
 	
 	statusCodePair = std::make_pair("301", "Moved Permanently");
 	mStatusCodesData[REDIRECT_MOVE] = statusCodePair;
@@ -18,11 +24,17 @@ void StatusCodeHandler::initializeStaticData() {
 	statusCodePair = std::make_pair("302", "Found");
 	mStatusCodesData[REDIRECT_FOUND] = statusCodePair;
 
+	statusCodePair = std::make_pair("304", "Not Modified");
+	mStatusCodesData[NOT_MODIFIED] = statusCodePair;
+
 	statusCodePair = std::make_pair("305", "Use Proxy");
 	mStatusCodesData[REDIRECT_PROXY] = statusCodePair;
 
 	statusCodePair = std::make_pair("307", "Temporary Redirect");
 	mStatusCodesData[REDIRECT_TEMPORARY] = statusCodePair;
+
+	statusCodePair = std::make_pair("308", "Resume Incomplete");
+	mStatusCodesData[RESUME_INCOMPLETE] = statusCodePair;
 	
 	statusCodePair = std::make_pair("400", "Bad Request");
 	mStatusCodesData[BAD_REQUEST] = statusCodePair;
@@ -42,6 +54,13 @@ void StatusCodeHandler::initializeStaticData() {
 	statusCodePair = std::make_pair("413", "Request Entity Too Large");
 	mStatusCodesData[ENTITY_LARGE] = statusCodePair;
 
+	statusCodePair = std::make_pair("416",
+		"Requested Range Not Satisfiable");
+	mStatusCodesData[RANGE_NOT_SATISFIABLE] = statusCodePair;
+
+	statusCodePair = std::make_pair("417", "Expectation Failed");
+	mStatusCodesData[EXPECTATION_FAILED] = statusCodePair;
+
 	statusCodePair = std::make_pair("500", "Internal Server Error");
 	mStatusCodesData[SERVER_ERROR] = statusCodePair;
 
@@ -50,6 +69,11 @@ void StatusCodeHandler::initializeStaticData() {
 
 }
 
+const StatusCodeHandler::StatusCodeMap&
+	StatusCodeHandler::getStatusCodes() {
+	return mStatusCodesData;
+}
+
 bool StatusCodeHandler::isRedirection(const StatusCodeType code) {
 
 	if (code != REDIRECT_MOVE && code != REDIRECT_TEMPORARY
@@ -16,17 +16,24 @@ class StatusCodeHandler {
 		/******* nested types *******/
 		enum StatusCodeType {
 			OK = 200,
+			CREATED = 201,
 			NO_CONTENT = 204,
+			PARTIAL_CONTENT = 206,
 			REDIRECT_MOVE = 301,
 			REDIRECT_FOUND = 302,
+			NOT_MODIFIED = 304,
 			REDIRECT_PROXY = 305,
 			REDIRECT_TEMPORARY = 307,
+			// a resumable upload that's missing bytes
+			RESUME_INCOMPLETE = 308,
 			BAD_REQUEST = 400,
 			NOT_FOUND = 404,
 			METHOD_ALLOW = 405,
 			LEN_REQUIRED = 411,
 			ENTITY_LARGE = 413,
 			URI_LONG = 414,
+			RANGE_NOT_SATISFIABLE = 416,
+			EXPECTATION_FAILED = 417,
 			SERVER_ERROR = 500,
 			NOT_IMPLEMENTED = 501
 		};
@@ -54,6 +61,9 @@ class StatusCodeHandler {
 		// checks if the passed code is one of the supported
 			// redirection codes
 		static bool isRedirection(const StatusCodeType code);
+
+		// returns all the supported status codes
+		static const StatusCodeMap& getStatusCodes();
 	
 	private:
 		static StatusCodeMap mStatusCodesData;
@@ -0,0 +1,195 @@
+/* this file contains the implementation of the ZeroCopySender class */
+
+#include <ZeroCopySender.hpp>
+
+unsigned long ZeroCopySender::mTotalSendsCount = 0;
+
+unsigned long ZeroCopySender::mTotalCompletedCount = 0;
+
+unsigned long ZeroCopySender::mTotalCopiedCount = 0;
+
+unsigned long ZeroCopySender::mTotalDeferredCount = 0;
+
+unsigned long ZeroCopySender::mTotalFallbacksCount = 0;
+
+const size_t ZeroCopySender::mSendSize = 256 * 1024;
+
+ZeroCopySender::ZeroCopySender(Socket socket)
+	: mSocket(socket)
+	, mState(UNTRIED)
+	, mIsBlocked(false)
+	, mSendsCount()
+	, mCompletedCount()
+	, mCopiedCount()
+	, mDeferredCount()
+	, mFallbacksCount() {}
+
+ssize_t ZeroCopySender::send(const char* data, size_t size) {
+
+	size = std::min(size, mSendSize);
+
+#ifdef ZEROCOPY_SUPPORTED
+
+	if (enable()) {
+
+		// frees the notifications of the previous sends
+			// since the kernel limits the memory they use
+		drainErrorQueue();
+
+		const ssize_t sentBytes =
+			::send(mSocket, data, size, MSG_ZEROCOPY);
+
+		if (sentBytes != -1) {
+			++mSendsCount;
+			++mTotalSendsCount;
+			return sentBytes;
+		}
+
+		if (errno != ENOBUFS)
+			return -1;
+
+		// the kernel can't track another zero-copy send
+			// until some of the pending ones complete, so
+			// the send is retried once they do
+		// if none is pending, the memory is used by other
+			// sockets and the send is retried on the next
+			// writable event
+		++mDeferredCount;
+		++mTotalDeferredCount;
+		mIsBlocked = isPending();
+		errno = EAGAIN;
+		return -1;
+
+	}
+
+#endif
+
+	++mFallbacksCount;
+	++mTotalFallbacksCount;
+	return write(mSocket, data, size);
+
+}
+
+bool ZeroCopySender::readCompletions() {
+
+	drainErrorQueue();
+	mIsBlocked = false;
+
+	if (isPending() == false)
+		return true;
+
+	// the socket is also readable when the client sends
+		// something or closes the connection, so whatever
+		// it sends is discarded
+	char buffer[1024];
+	const ssize_t readBytes =
+		recv(mSocket, buffer, sizeof(buffer), MSG_DONTWAIT);
+
+	if (readBytes == 0)
+		return false;
+
+	return (readBytes != -1
+		|| errno == EAGAIN || errno == EWOULDBLOCK);
+
+}
+
+bool ZeroCopySender::isPending() const {
+	return (mCompletedCount < mSendsCount);
+}
+
+bool ZeroCopySender::isBlocked() const {
+	return mIsBlocked;
+}
+
+std::string ZeroCopySender::getReport() const {
+	return formatReport(mSendsCount, mCompletedCount,
+		mCopiedCount, mDeferredCount, mFallbacksCount);
+}
+
+std::string ZeroCopySender::getTotalsReport() {
+	return formatReport(mTotalSendsCount, mTotalCompletedCount,
+		mTotalCopiedCount, mTotalDeferredCount, mTotalFallbacksCount);
+}
+
+std::string ZeroCopySender::formatReport(const unsigned long sends,
+	const unsigned long completed, const unsigned long copied,
+	const unsigned long deferred, const unsigned long fallbacks) {
+
+	if (sends == 0 && fallbacks == 0)
+		return "";
+
+	return "zero-copy sends: " + toString(sends)
+		+ " (" + toString(completed) + " completed, "
+		+ toString(copied) + " copied by the kernel, "
+		+ toString(deferred) + " deferred), "
+		+ "normal writes: " + toString(fallbacks);
+
+}
+
+bool ZeroCopySender::enable() {
+
+#ifdef ZEROCOPY_SUPPORTED
+
+	if (mState == UNTRIED) {
+
+		const int enable = 1;
+		mState = setsockopt(mSocket, SOL_SOCKET, SO_ZEROCOPY,
+			&enable, sizeof(enable)) == 0 ? ENABLED : UNSUPPORTED;
+
+	}
+
+#endif
+
+	return (mState == ENABLED);
+
+}
+
+void ZeroCopySender::drainErrorQueue() {
+
+#ifdef ZEROCOPY_SUPPORTED
+
+	while (isPending()) {
+
+		char control[128];
+		struct msghdr message = msghdr();
+		message.msg_control = control;
+		message.msg_controllen = sizeof(control);
+
+		if (recvmsg(mSocket, &message, MSG_ERRQUEUE | MSG_DONTWAIT) == -1)
+			return;
+
+		for (struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+			header; header = CMSG_NXTHDR(&message, header)) {
+
+			if ((header->cmsg_level != SOL_IP
+					|| header->cmsg_type != IP_RECVERR)
+				&& (header->cmsg_level != SOL_IPV6
+					|| header->cmsg_type != IPV6_RECVERR))
+				continue;
+
+			const struct sock_extended_err* error =
+				reinterpret_cast<const struct sock_extended_err*>
+					(CMSG_DATA(header));
+
+			if (error->ee_errno != 0
+				|| error->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+				continue;
+
+			// the notification covers the sends numbered
+				// from ee_info to ee_data
+			const unsigned int count = error->ee_data - error->ee_info + 1;
+
+			mCompletedCount += count;
+			mTotalCompletedCount += count;
+			if (error->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+				mCopiedCount += count;
+				mTotalCopiedCount += count;
+			}
+
+		}
+
+	}
+
+#endif
+
+}
@@ -0,0 +1,147 @@
+/* this file contains the definition of the ZeroCopySender class
+ * It sends large in-memory bodies over a client socket with
+ *  MSG_ZEROCOPY (linux only) so that the kernel transmits them from
+ *  their own pages instead of copying them to the socket buffer.
+ * The pages stay in use by the kernel after send() returns: each
+ *  zero-copy send is numbered and the kernel queues a notification
+ *  on the error queue of the socket once it's done with a range of
+ *  sends. The sent data must stay unchanged until isPending() is
+ *  false, so its owner waits for these notifications (which make the
+ *  socket readable) before releasing it.
+ * A notification may say that the kernel had to copy the data anyway
+ *  (like on the loopback interface). When the kernel can't track more
+ *  zero-copy sends (ENOBUFS), the send is deferred until the pending
+ *  ones complete. Where MSG_ZEROCOPY isn't supported, the data is
+ *  written normally.
+ * Each call sends a bounded slice so that a slow client doesn't hold
+ *  the event loop, and like write() on a full socket buffer, -1 with
+ *  errno set to EAGAIN means the send should be retried later.
+ * The counts of each sender are also added to totals
+ *  of the whole process.
+ */
+
+#pragma once
+
+#include <string>
+#include <algorithm>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <utils.hpp>
+
+#if defined(__linux__)
+	#include <linux/errqueue.h>
+#endif
+
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY) \
+	&& defined(SO_EE_ORIGIN_ZEROCOPY)
+	#define ZEROCOPY_SUPPORTED
+#endif
+
+class ZeroCopySender {
+
+	public:
+		/******* alias types *******/
+		typedef int Socket;
+
+		/******* public member functions *******/
+		ZeroCopySender(Socket socket);
+
+		// sends up to size bytes of data (at most mSendSize)
+			// and returns the amount of sent bytes or -1 on error
+			// (like write() on a non-blocking socket)
+		// data must stay unchanged until isPending() is false
+		// SO_ZEROCOPY is enabled on the socket the first time
+			// and data is written normally if it can't be
+		// fails with EAGAIN and sets isBlocked() if the kernel
+			// can't track another zero-copy send
+		ssize_t send(const char* data, size_t size);
+
+		// reads the notifications of the kernel about
+			// the zero-copy sends it's done with
+		// clears isBlocked() so that the send is retried
+		// returns false if the peer closed the connection or
+			// the socket failed, since the sends that are still
+			// pending won't be waited for anymore
+		bool readCompletions();
+
+		// checks if the kernel may still use the sent data
+		bool isPending() const;
+
+		// checks if a send is deferred until the pending sends
+			// complete, which makes the socket readable
+		bool isBlocked() const;
+
+		// returns the counts of zero-copy sends, completed
+			// and copied sends, deferred sends and normal writes,
+			// or an empty
+			// string if nothing was sent with send()
+		std::string getReport() const;
+
+		// same as getReport() for all the senders
+			// since the server started
+		static std::string getTotalsReport();
+
+	private:
+		/******* nested types *******/
+		// whether SO_ZEROCOPY is set on the socket
+		enum State {
+			UNTRIED,
+			ENABLED,
+			UNSUPPORTED
+		};
+
+		/******* private member objects *******/
+		Socket mSocket;
+
+		State mState;
+
+		// whether the last send failed with ENOBUFS
+			// while zero-copy sends were pending
+		bool mIsBlocked;
+
+		// number of sends made with MSG_ZEROCOPY
+		// (the kernel numbers them from 0 so it's
+			// also the number of the next one)
+		unsigned int mSendsCount;
+
+		// number of zero-copy sends the kernel is done with
+		unsigned int mCompletedCount;
+
+		// number of completed sends whose data
+			// was copied by the kernel anyway
+		unsigned int mCopiedCount;
+
+		// number of sends deferred because of ENOBUFS
+		unsigned int mDeferredCount;
+
+		// number of sends that were written normally
+		unsigned int mFallbacksCount;
+
+		// sums of the above counts of all the senders
+		static unsigned long mTotalSendsCount;
+		static unsigned long mTotalCompletedCount;
+		static unsigned long mTotalCopiedCount;
+		static unsigned long mTotalDeferredCount;
+		static unsigned long mTotalFallbacksCount;
+
+		// max number of bytes sent by each call of send()
+		static const size_t mSendSize;
+
+		/******* private member functions *******/
+		// sets SO_ZEROCOPY on the socket if it wasn't tried before
+		// returns false if it isn't supported
+		bool enable();
+
+		// reads the notifications queued on the error
+			// queue of the socket without blocking
+		void drainErrorQueue();
+
+		// formats the counts of getReport()
+		static std::string formatReport(const unsigned long sends,
+			const unsigned long completed, const unsigned long copied,
+			const unsigned long deferred, const unsigned long fallbacks);
+
+};
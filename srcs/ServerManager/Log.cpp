@@ -19,22 +19,9 @@ std::ofstream Log::mLogfile("./log_files/basic_logfile",
 	// then localtime() to convert it to local time expression
 void Log::addTimeDate() {
 
-	// Get the current time
-	time_t rawTime = time(0);
-
-  	// Convert to local time expression
-  	tm* timeInfo = localtime(&rawTime);
-
-  	// retrieve the date and time from tm struct returned by localtime()
-		// and print it in the format [YYYY-MM-DD HH:MM:SS]
-		// by appending the characters "[ ]-:" to timeInfo struct members
-  	mLogfile << "["
-			<< timeInfo->tm_year + 1900 << '-'
-            << timeInfo->tm_mon + 1 << '-'
-            << timeInfo->tm_mday << ' '
-            << timeInfo->tm_hour << ':'
-            << timeInfo->tm_min << ':'
-            << timeInfo->tm_sec << "] ";
+	// the timestamp is formatted at most
+		// once per second by TimeCache
+	mLogfile << TimeCache::getLogDate();
 
 }
 
@@ -152,6 +139,15 @@ void Log::error(const std::string& errorMsg) {
 
 }
 
+void Log::info(const std::string& infoMsg) {
+
+	addTimeDate();
+
+	mLogfile << mInfoNotice << infoMsg
+		<< std::endl;
+
+}
+
 void Log::logClientServerOperation(
 	const Socket socket, const std::string& notice,
 	const std::string& op, const std::string& clientPrep,
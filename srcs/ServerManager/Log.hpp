@@ -7,6 +7,7 @@
  * + request receipt
  * + response sending
  * + error messages when some operation fails
+ * + statistics of the server (like the zero-copy totals)
  * The log functions mostly take a socket only and the hostname
  * and port of the peer or the server is determined from that socket
 */
@@ -16,6 +17,7 @@
 #include <fstream>
 #include <string>
 #include <Network.hpp>
+#include <TimeCache.hpp>
 
 class Log {
 
@@ -55,6 +57,10 @@ class Log {
 		// logs error messages
 		static void error(const std::string& errorMsg);
 
+		// logs messages about the server as a whole
+			// (like statistics)
+		static void info(const std::string& infoMsg);
+
 	private:
 		/******* private member objects *******/
 		static std::ofstream mLogfile;
@@ -68,6 +74,7 @@ class Log {
 		/******* private member functions *******/
 		// writes date and time to the log file 
 			// in format [YYYY-MM-DD HH:MM:SS]
+		// it's taken from TimeCache
 		static void addTimeDate();
 
 		// this is a general utility used by other methods that
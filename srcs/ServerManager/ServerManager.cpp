@@ -6,16 +6,67 @@
 const std::string
 	ServerManager::mTmpFilesDir = "./.tmp_files/";
 
+const std::time_t ServerManager::mZeroCopyReportInterval = 60;
+
 ServerManager::ServerManager(const char* configFileName)
 	: mConfig(configFileName)
 	, mServers(mConfig.getServers())
-	, mMimeTypes(NULL) {
+	, mMimeTypes(NULL)
+	, mZeroCopyReportTime() {
 
 		makeTmpFilesDir();
 
+		// temporary files that are kept on the disk
+			// are created (unnamed) in that directory
+		TempFile::setDirectory(mTmpFilesDir);
+
 		Network::initServersSockets(mConfig.getServers());
 		initializeStaticData();
 
+		// error pages are served from memory
+		ErrorPages::load(mConfig.getServers());
+
+		// the asset packs are mapped once
+		AssetPack::load(mConfig.getServers());
+
+		prewarmFiles();
+
+}
+
+void ServerManager::prewarmFiles() {
+
+	for (Servers::const_iterator server = mServers.begin();
+		server != mServers.end(); ++server) {
+
+		for (std::vector<Config::Path>::const_iterator path
+			= server->prewarmPaths.begin();
+			path != server->prewarmPaths.end(); ++path) {
+
+			// the path is resolved the same way
+				// a requested path would be
+			const Config::ConstLocPtr location
+				= server->matchLocation(*path);
+
+			FileInfo file;
+
+			if (location == NULL
+				|| file.open(location->replaceByRoot(*path)) == false
+				|| file.isRegular() == false || file.getFd() == -1) {
+
+				Log::error("prewarm path '" + *path
+					+ "' couldn't be opened");
+				continue;
+
+			}
+
+			// the file is read in the background and
+				// stays in the page cache after it's closed
+			file.adviseWillNeed(0, 0);
+
+		}
+
+	}
+
 }
 
 void ServerManager::initializeStaticData() {
@@ -55,13 +106,35 @@ void ServerManager::manageClientHandlers() {
 			Log::error(error.what());
 		}
 
+		// the events of this iteration share the same time
+		TimeCache::update();
+
 		manageNewConnections();
 		informClientHandlers();
 
+		logZeroCopyTotals();
+
 	}
 
 }
 
+void ServerManager::logZeroCopyTotals() {
+
+	if (TimeCache::getTime() - mZeroCopyReportTime
+		< mZeroCopyReportInterval)
+		return;
+
+	// the totals are only logged when they changed
+	const std::string report = ZeroCopySender::getTotalsReport();
+	if (report == mZeroCopyReport)
+		return;
+
+	Log::info("total " + report);
+	mZeroCopyReport = report;
+	mZeroCopyReportTime = TimeCache::getTime();
+
+}
+
 void ServerManager::queryClientHandlers() {
 
 	mReadFDs.clear();
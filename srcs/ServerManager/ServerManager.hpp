@@ -10,10 +10,14 @@
 
 #include <Config.hpp>
 #include <Log.hpp>
+#include <TimeCache.hpp>
 #include <Multiplexer.hpp>
 #include <Network.hpp>
 #include <MimeTypes.hpp>
+#include <AssetPack.hpp>
+#include <TempFile.hpp>
 #include <ClientHandler.hpp>
+#include <ZeroCopySender.hpp>
 #include <RequestHeaders.hpp>
 #include <sys/stat.h>
 
@@ -63,9 +67,19 @@ class ServerManager {
 		FDCollection mListenFDs;
 
 		// directory where the temporary files of
-			// the program will be created
+			// the program will be created (they have
+			// no name when O_TMPFILE is supported)
 		static const std::string mTmpFilesDir;
 
+		// last report of the zero-copy totals that was
+			// logged and when it was logged
+		std::string mZeroCopyReport;
+		std::time_t mZeroCopyReportTime;
+
+		// minimum number of seconds between
+			// two reports of the zero-copy totals
+		static const std::time_t mZeroCopyReportInterval;
+
 		/******* private member functions *******/
 		// queries client Handlers for their state (if they need
 			// multiplexing)
@@ -76,6 +90,11 @@ class ServerManager {
 			// handler is added by calling addClientHandler()
 		void manageClientHandlers();
 
+		// logs the totals of the zero-copy sends when they
+			// changed since the last report, at most once
+			// every mZeroCopyReportInterval seconds
+		void logZeroCopyTotals();
+
 		// Checks the state of the client handlers by asking if they have
 			// any multiplexing needs and if so it adds their socket to appropriate
 			// collection (mReadFDs or mWriteFDs) These 2 member objects are
@@ -131,6 +150,11 @@ class ServerManager {
 			// static structures will be called here
 		static void initializeStaticData();
 
+		// asks the kernel to read the files listed by the prewarm
+			// directive of each server into the page cache
+		// a path that can't be opened is logged and skipped
+		void prewarmFiles();
+
 		// creates the temporary files directory
 			// if it doesn't exist
 		// throws std::runtime_error on error
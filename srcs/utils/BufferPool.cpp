@@ -0,0 +1,42 @@
+/* this file contains the implementation of the BufferPool class */
+
+#include <BufferPool.hpp>
+
+std::vector<std::string> BufferPool::mBuffers;
+
+const size_t BufferPool::mMaxBuffers = 64;
+
+const size_t BufferPool::mMaxCapacity = 1024 * 1024;
+
+void BufferPool::acquire(std::string& buffer,
+	const size_t capacity) {
+
+	if (mBuffers.empty() == false) {
+		buffer.swap(mBuffers.back());
+		mBuffers.pop_back();
+	}
+
+	// clearing a string keeps its storage
+	buffer.clear();
+	buffer.reserve(capacity);
+
+}
+
+void BufferPool::release(std::string& buffer) {
+
+	// nothing was allocated for it
+	if (buffer.capacity() <= std::string().capacity())
+		return ;
+
+	if (mBuffers.size() < mMaxBuffers
+		&& buffer.capacity() <= mMaxCapacity) {
+
+		mBuffers.push_back(std::string());
+		mBuffers.back().swap(buffer);
+		return ;
+
+	}
+
+	std::string().swap(buffer);
+
+}
@@ -0,0 +1,38 @@
+/* this file contains the definition of the BufferPool class
+ * It keeps the storage of the strings that held request bodies in
+ *  memory once their requests are done so that the next bodies are
+ *  appended to an already allocated buffer instead of a new one
+ * A buffer is taken with acquire() and given back with release();
+ *  only a limited number of buffers that aren't too large are kept
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+class BufferPool {
+
+	public:
+		/******* public member functions *******/
+		// replaces buffer with an empty string that can hold
+			// at least capacity bytes, using a kept one if any
+		static void acquire(std::string& buffer,
+			const size_t capacity);
+
+		// takes the storage of buffer which is left empty
+			// (the storage is freed if it's not kept)
+		static void release(std::string& buffer);
+
+	private:
+		/******* private member objects *******/
+		// empty strings with an allocated storage
+		static std::vector<std::string> mBuffers;
+
+		// number of buffers that are kept at most
+		static const size_t mMaxBuffers;
+
+		// buffers larger than this are freed
+		static const size_t mMaxCapacity;
+
+};
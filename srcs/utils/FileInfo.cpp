@@ -0,0 +1,161 @@
+/* this file contains the implementation of the FileInfo class */
+
+#include <FileInfo.hpp>
+
+FileInfo::FileInfo()
+	: mFd(-1)
+	, mIsPath()
+	, mMode()
+	, mSize()
+	, mModTime() {}
+
+FileInfo::~FileInfo() {
+	close();
+}
+
+bool FileInfo::open(const std::string& path) {
+
+	close();
+
+	struct stat info;
+
+	// non blocking so that opening a fifo doesn't
+		// block the server and close-on-exec so that
+		// it isn't inherited by cgi scripts
+	mFd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+
+	if (mFd != -1) {
+
+		if (fstat(mFd, &info) == 0) {
+			setMetadata(info);
+			return true;
+		}
+
+		close();
+		return false;
+
+	}
+
+	// the path may exist without being readable
+	if (stat(path.c_str(), &info))
+		return false;
+
+	setMetadata(info);
+
+	return true;
+
+}
+
+bool FileInfo::adopt(const int fd) {
+
+	close();
+
+	struct stat info;
+
+	mFd = fd;
+
+	if (mFd == -1 || fstat(mFd, &info)) {
+		close();
+		return false;
+	}
+
+	setMetadata(info);
+
+	return true;
+
+}
+
+void FileInfo::close() {
+
+	if (mFd != -1)
+		::close(mFd);
+
+	mFd = -1;
+	mIsPath = false;
+	mMode = 0;
+	mSize = 0;
+	mModTime = 0;
+
+}
+
+void FileInfo::swap(FileInfo& fileInfo) {
+
+	std::swap(mFd, fileInfo.mFd);
+	std::swap(mIsPath, fileInfo.mIsPath);
+	std::swap(mMode, fileInfo.mMode);
+	std::swap(mSize, fileInfo.mSize);
+	std::swap(mModTime, fileInfo.mModTime);
+
+}
+
+bool FileInfo::isPath() const {
+	return mIsPath;
+}
+
+bool FileInfo::isDir() const {
+	return (mIsPath && S_ISDIR(mMode));
+}
+
+bool FileInfo::isRegular() const {
+	return (mIsPath && S_ISREG(mMode));
+}
+
+size_t FileInfo::getSize() const {
+	return mSize;
+}
+
+std::time_t FileInfo::getModTime() const {
+	return mModTime;
+}
+
+int FileInfo::getFd() const {
+	return mFd;
+}
+
+void FileInfo::adviseSequential() const {
+
+	if (mFd == -1)
+		return;
+
+#ifdef POSIX_FADV_SEQUENTIAL
+	posix_fadvise(mFd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+}
+
+void FileInfo::adviseWillNeed(const off_t offset,
+	const size_t length) const {
+
+	if (mFd == -1)
+		return;
+
+#if defined(__linux__)
+	readahead(mFd, offset, length ? length : mSize);
+#elif defined(POSIX_FADV_WILLNEED)
+	posix_fadvise(mFd, offset, length, POSIX_FADV_WILLNEED);
+#else
+	(void) offset;
+	(void) length;
+#endif
+
+}
+
+void FileInfo::adviseDontNeed() const {
+
+	if (mFd == -1)
+		return;
+
+#ifdef POSIX_FADV_DONTNEED
+	posix_fadvise(mFd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+
+}
+
+void FileInfo::setMetadata(const struct stat& info) {
+
+	mIsPath = true;
+	mMode = info.st_mode;
+	mSize = info.st_size;
+	mModTime = info.st_mtime;
+
+}
@@ -0,0 +1,104 @@
+/* this file contains the definition of the FileInfo class
+ * It resolves a path with a single open() followed by an fstat()
+ *  on the obtained file descriptor, and keeps both the descriptor
+ *  and the metadata (type, size, modification time) so that the
+ *  request classification and the response that serves the file
+ *  share them instead of querying the filesystem again
+ * The descriptor is owned by the object and closed by it
+ * It also passes access pattern hints about the file to the kernel
+ *  where they are supported (posix_fadvise(), readahead())
+ */
+
+#pragma once
+
+#include <string>
+#include <ctime>
+#include <cstddef>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+class FileInfo {
+
+	public:
+		/******* public member functions *******/
+		FileInfo();
+
+		~FileInfo();
+
+		// resolves path and replaces any previously
+			// resolved one
+		// returns false if path doesn't exist
+		// if path exists but can't be opened (no read
+			// permission), its metadata is still set
+			// but it has no file descriptor
+		bool open(const std::string& path);
+
+		// takes the ownership of an already opened descriptor
+			// (like a TempFile's) and sets its metadata
+		// returns false and closes fd if its
+			// metadata can't be retrieved
+		bool adopt(const int fd);
+
+		// closes the file descriptor and clears the metadata
+		void close();
+
+		// exchanges the descriptors and metadata
+			// of the two objects
+		void swap(FileInfo& fileInfo);
+
+		// returns true if the resolved path exists
+		bool isPath() const;
+
+		bool isDir() const;
+
+		bool isRegular() const;
+
+		size_t getSize() const;
+
+		std::time_t getModTime() const;
+
+		// returns the read-only file descriptor
+			// of the path or -1 if it wasn't opened
+		int getFd() const;
+
+		// hints that the file will be read sequentially
+			// so that the kernel reads further ahead
+		void adviseSequential() const;
+
+		// starts reading length bytes from offset into
+			// the page cache (0 means up to the end)
+			// without waiting for them
+		void adviseWillNeed(const off_t offset,
+			const size_t length) const;
+
+		// hints that the cached pages of the file won't be
+			// needed anymore so that they are evicted before
+			// the ones of other files
+		void adviseDontNeed() const;
+
+	private:
+		/******* private member objects *******/
+		int mFd;
+
+		bool mIsPath;
+
+		// file type and mode bits
+		mode_t mMode;
+
+		size_t mSize;
+
+		std::time_t mModTime;
+
+		/******* private member functions *******/
+		// copying would close the same
+			// descriptor twice
+		FileInfo(const FileInfo&);
+
+		FileInfo& operator=(const FileInfo&);
+
+		// sets the metadata from info
+		void setMetadata(const struct stat& info);
+
+};
@@ -0,0 +1,346 @@
+/* this file contains the implementation of the FileWriter class */
+
+#include <FileWriter.hpp>
+
+std::vector<char*> FileWriter::mFreeBlocks;
+
+const size_t FileWriter::mBlockSize = 1024 * 1024;
+
+const size_t FileWriter::mAlignment = 4096;
+
+const size_t FileWriter::mMaxFreeBlocks = 16;
+
+FileWriter::FileWriter()
+	: mFd(-1)
+	, mIsDirect()
+	, mSyncPolicy(Config::LocationContext::SYNC_OFF)
+	, mSyncInterval()
+	, mUnsyncedSize()
+	, mBlock()
+	, mBlockUsed() {}
+
+FileWriter::~FileWriter() {
+	close();
+}
+
+void FileWriter::create(const std::string& directory,
+	const bool isDirect) {
+
+	close();
+
+#ifdef O_TMPFILE
+	// an unnamed inode of the directory's filesystem
+	const int flags = O_TMPFILE | O_WRONLY | O_CLOEXEC;
+
+# ifdef O_DIRECT
+	if (isDirect) {
+		mFd = ::open(directory.c_str(), flags | O_DIRECT, 0666);
+		mIsDirect = (mFd != -1);
+	}
+# endif
+
+	// O_DIRECT isn't supported by every filesystem
+	if (mFd == -1)
+		mFd = ::open(directory.c_str(), flags, 0666);
+#endif
+
+	// neither is O_TMPFILE
+	if (mFd == -1)
+		createNamed(directory, isDirect);
+
+}
+
+void FileWriter::openAt(const std::string& path, const off_t offset) {
+
+	close();
+
+	mFd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0666);
+
+	if (mFd == -1)
+		throwErrnoException("FileWriter::openAt(): '" + path + '\'');
+
+	// the writes (and splices) that follow go from offset on
+		// as if they were made with pwrite()
+	if (lseek(mFd, offset, SEEK_SET) == -1)
+		throwErrnoException("FileWriter::openAt(): '" + path + '\'');
+
+}
+
+void FileWriter::preallocate(const size_t size) {
+
+#if defined(__linux__) && defined(FALLOC_FL_KEEP_SIZE)
+	// the size of the file still grows with the writes
+		// so an unfinished file only has the written bytes
+	if (size)
+		fallocate(mFd, FALLOC_FL_KEEP_SIZE, 0, size);
+#else
+	static_cast<void>(size);
+#endif
+
+}
+
+void FileWriter::setSync(const SyncPolicy policy, const Size interval) {
+
+	mSyncPolicy = policy;
+	mSyncInterval = interval;
+
+}
+
+void FileWriter::write(const char* data, size_t size) {
+
+	while (size) {
+
+		// whole blocks go to the file without being copied
+			// (unless they need an aligned memory)
+		if (mBlockUsed == 0 && size >= mBlockSize && mIsDirect == false) {
+
+			const size_t blocksSize = size - size % mBlockSize;
+			writeToFd(data, blocksSize);
+			data += blocksSize;
+			size -= blocksSize;
+			continue;
+
+		}
+
+		if (mBlock == NULL)
+			mBlock = acquireBlock();
+
+		const size_t copySize = std::min(size, mBlockSize - mBlockUsed);
+
+		std::memcpy(mBlock + mBlockUsed, data, copySize);
+		mBlockUsed += copySize;
+		data += copySize;
+		size -= copySize;
+
+		if (mBlockUsed == mBlockSize) {
+			writeToFd(mBlock, mBlockSize);
+			mBlockUsed = 0;
+		}
+
+	}
+
+}
+
+void FileWriter::flush() {
+
+	if (mBlockUsed == 0)
+		return ;
+
+#ifdef O_DIRECT
+	// a partial block can't be written with O_DIRECT
+	if (mIsDirect) {
+		fcntl(mFd, F_SETFL, fcntl(mFd, F_GETFL) & ~O_DIRECT);
+		mIsDirect = false;
+	}
+#endif
+
+	writeToFd(mBlock, mBlockUsed);
+	mBlockUsed = 0;
+
+}
+
+int FileWriter::getFd() const {
+	return mFd;
+}
+
+void FileWriter::addWritten(const size_t size) {
+
+	mUnsyncedSize += size;
+
+	if (mSyncPolicy == Config::LocationContext::SYNC_PERIODIC
+		&& mUnsyncedSize >= mSyncInterval)
+		sync();
+
+}
+
+void FileWriter::finish() {
+
+	flush();
+
+	if (mSyncPolicy != Config::LocationContext::SYNC_OFF
+		&& mUnsyncedSize)
+		sync();
+
+	// the block can be used by another file
+	if (mBlock) {
+		releaseBlock(mBlock);
+		mBlock = NULL;
+	}
+
+}
+
+bool FileWriter::isDirect() const {
+	return mIsDirect;
+}
+
+bool FileWriter::commit(const std::string& path) {
+
+	int result = -1;
+
+#ifdef O_TMPFILE
+	// linking the descriptor itself (AT_EMPTY_PATH) needs a
+		// capability, unlike linking its /proc entry
+	if (mTempPath.empty()) {
+
+		const std::string fdPath = "/proc/self/fd/" + toString(mFd);
+
+		result = linkat(AT_FDCWD, fdPath.c_str(),
+			AT_FDCWD, path.c_str(), AT_SYMLINK_FOLLOW);
+
+	}
+#endif
+
+	// unlike rename(), link() doesn't replace an existing file
+	if (mTempPath.empty() == false) {
+
+		result = link(mTempPath.c_str(), path.c_str());
+
+		if (result == 0) {
+			unlink(mTempPath.c_str());
+			mTempPath.clear();
+		}
+
+	}
+
+	if (result == -1 && errno == EEXIST)
+		return false;
+
+	if (result == -1)
+		throwErrnoException("FileWriter::commit(): '" + path + '\'');
+
+	// the new name is synced along with the data
+	if (mSyncPolicy != Config::LocationContext::SYNC_OFF)
+		syncDirectory(path);
+
+	return true;
+
+}
+
+void FileWriter::close() {
+
+	if (mBlock)
+		releaseBlock(mBlock);
+
+	if (mFd != -1)
+		::close(mFd);
+
+	// a named file that wasn't committed
+	if (mTempPath.empty() == false)
+		unlink(mTempPath.c_str());
+
+	mFd = -1;
+	mTempPath.clear();
+	mIsDirect = false;
+	mUnsyncedSize = 0;
+	mBlock = NULL;
+	mBlockUsed = 0;
+
+}
+
+void FileWriter::createNamed(const std::string& directory,
+	const bool isDirect) {
+
+	// a hidden name in the same directory so that
+		// it can be linked to its path
+	mTempPath = directory + "/.upload_XXXXXX";
+
+	mFd = mkstemp(&mTempPath[0]);
+
+	if (mFd == -1) {
+		mTempPath.clear();
+		throwErrnoException("FileWriter::create(): '" + directory + '\'');
+	}
+
+	fcntl(mFd, F_SETFD, FD_CLOEXEC);
+
+	// mkstemp() only lets the owner read the file
+	const mode_t mask = umask(0);
+	umask(mask);
+	fchmod(mFd, 0666 & ~mask);
+
+#ifdef O_DIRECT
+	if (isDirect)
+		mIsDirect = (fcntl(mFd, F_SETFL,
+			fcntl(mFd, F_GETFL) | O_DIRECT) != -1);
+#else
+	static_cast<void>(isDirect);
+#endif
+
+}
+
+void FileWriter::writeToFd(const char* data, const size_t size) {
+
+	::writeToFd(mFd, data, size);
+
+	addWritten(size);
+
+}
+
+void FileWriter::sync() {
+
+#ifdef __linux__
+	// the metadata that isn't needed to read
+		// the data back isn't synced
+	const int result = fdatasync(mFd);
+#else
+	const int result = fsync(mFd);
+#endif
+
+	if (result == -1)
+		throwErrnoException("FileWriter::sync()");
+
+	mUnsyncedSize = 0;
+
+}
+
+void FileWriter::syncDirectory(const std::string& path) {
+
+	const std::string::size_type separatorPos = path.rfind('/');
+	const std::string directory = separatorPos == std::string::npos
+		? "." : path.substr(0, separatorPos + 1);
+
+	const int directoryFd = ::open(directory.c_str(),
+		O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+	if (directoryFd == -1 || fsync(directoryFd) == -1) {
+
+		const int error = errno;
+
+		if (directoryFd != -1)
+			::close(directoryFd);
+
+		errno = error;
+		throwErrnoException("FileWriter::syncDirectory(): '"
+			+ directory + '\'');
+
+	}
+
+	::close(directoryFd);
+
+}
+
+char* FileWriter::acquireBlock() {
+
+	if (mFreeBlocks.empty() == false) {
+		char* block = mFreeBlocks.back();
+		mFreeBlocks.pop_back();
+		return block;
+	}
+
+	void* block = NULL;
+	if (posix_memalign(&block, mAlignment, mBlockSize))
+		throw std::runtime_error("FileWriter::acquireBlock(): "
+			"couldn't allocate a block");
+
+	return static_cast<char*>(block);
+
+}
+
+void FileWriter::releaseBlock(char* block) {
+
+	if (mFreeBlocks.size() < mMaxFreeBlocks)
+		mFreeBlocks.push_back(block);
+	else
+		std::free(block);
+
+}
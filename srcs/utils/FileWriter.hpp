@@ -0,0 +1,174 @@
+/* this file contains the definition of the FileWriter class
+ * It writes a file that's received in many small slices (like an
+ *  uploaded body) in large blocks: the slices are gathered in an
+ *  aligned block which is written once it's full, so every write
+ *  but the last one is a whole block at an offset aligned to it
+ * The space of the file can be reserved up front when its size is
+ *  known (linux only) so that the filesystem allocates it at once
+ *  instead of a few KB at a time.
+ * With the direct option, the file is opened with O_DIRECT when the
+ *  filesystem allows it so that the blocks bypass the page cache.
+ * The file is synced to the disk according to a SyncPolicy: never,
+ *  once it's written or each time a number of bytes is written.
+ * The file is written without a name (O_TMPFILE) in the directory
+ *  where it goes and is linked to its path only once it's committed,
+ *  so it's never seen partially written and a file that isn't
+ *  committed disappears when it's closed. Where O_TMPFILE isn't
+ *  supported, it's written under a hidden temporary name instead.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <Config.hpp>
+#include <utils.hpp>
+
+class FileWriter {
+
+	public:
+		/******* alias types *******/
+		typedef Config::LocationContext::SyncPolicy SyncPolicy;
+		typedef Config::Size Size;
+
+		/******* public member functions *******/
+		FileWriter();
+
+		// closes the file without syncing it
+			// (see close())
+		~FileWriter();
+
+		// creates an unnamed file in directory (see commit())
+		// if isDirect is set, O_DIRECT is used when
+			// the filesystem supports it
+		// throws std::runtime_error on error
+		void create(const std::string& directory, const bool isDirect);
+
+		// opens path (created if it doesn't exist) to write
+			// it from offset on without changing the rest of
+			// its content (it's already named so it's not
+			// committed)
+		// throws std::runtime_error on error
+		void openAt(const std::string& path, const off_t offset);
+
+		// reserves size bytes for the file without changing
+			// its size (it's only a hint, so errors are ignored)
+		void preallocate(const size_t size);
+
+		// sets when the file is synced (see SyncPolicy)
+			// interval is used by SYNC_PERIODIC
+		void setSync(const SyncPolicy policy, const Size interval);
+
+		// appends size bytes of data to the file
+		// throws std::runtime_error on error
+		void write(const char* data, size_t size);
+
+		// writes the gathered bytes so that the descriptor
+			// can be written to directly
+		// throws std::runtime_error on error
+		void flush();
+
+		// returns the descriptor of the file
+			// (flush() should be called before writing to it)
+		int getFd() const;
+
+		// counts size bytes that were written to the
+			// descriptor directly (for the periodic syncs)
+		// throws std::runtime_error on error
+		void addWritten(const size_t size);
+
+		// writes the rest of the file and syncs it unless the
+			// policy is SYNC_OFF (the file stays open)
+		// throws std::runtime_error on error
+		void finish();
+
+		// returns true if O_DIRECT is in use
+		bool isDirect() const;
+
+		// links the file to path (which must be in the directory
+			// given to create()) once it's finished and syncs
+			// the directory unless the policy is SYNC_OFF
+		// returns false if path already exists
+		// throws std::runtime_error on error
+		bool commit(const std::string& path);
+
+		// closes the file without syncing it (another one can
+			// then be created) and removes it if it
+			// wasn't committed
+		void close();
+
+	private:
+		/******* private member objects *******/
+		int mFd;
+
+		// name of the file until it's committed if it
+			// couldn't be created without one
+		std::string mTempPath;
+
+		bool mIsDirect;
+
+		SyncPolicy mSyncPolicy;
+
+		Size mSyncInterval;
+
+		// bytes written since the last sync
+		Size mUnsyncedSize;
+
+		// aligned block of mBlockSize bytes (NULL until
+			// the first write)
+		char* mBlock;
+
+		// number of bytes gathered in mBlock
+		size_t mBlockUsed;
+
+		// the blocks of the closed writers for the next ones
+		static std::vector<char*> mFreeBlocks;
+
+		// size of the writes which is a multiple of
+			// any logical block size of the disks
+		static const size_t mBlockSize;
+
+		// alignment of mBlock in memory required by O_DIRECT
+		static const size_t mAlignment;
+
+		// number of free blocks kept at most
+		static const size_t mMaxFreeBlocks;
+
+		/******* private member functions *******/
+		// writes size bytes of data to mFd
+		// throws std::runtime_error on error
+		void writeToFd(const char* data, const size_t size);
+
+		// syncs the written data of the file
+		// throws std::runtime_error on error
+		void sync();
+
+		// creates the file under a temporary name in directory
+		// throws std::runtime_error on error
+		void createNamed(const std::string& directory,
+			const bool isDirect);
+
+		// syncs the directory of path
+		// throws std::runtime_error on error
+		static void syncDirectory(const std::string& path);
+
+		// the file can't be closed twice
+		FileWriter(const FileWriter&);
+
+		FileWriter& operator=(const FileWriter&);
+
+		// returns an aligned block of mBlockSize bytes
+		// throws std::runtime_error on error
+		static char* acquireBlock();
+
+		static void releaseBlock(char* block);
+
+};
@@ -0,0 +1,81 @@
+/* this file contains the implementation of the SharedBuffer class */
+
+#include <SharedBuffer.hpp>
+
+SharedBuffer::SharedBuffer()
+	: mStorage()
+	, mData()
+	, mSize() {}
+
+SharedBuffer::SharedBuffer(std::string& data)
+	: mStorage(new Storage)
+	, mData()
+	, mSize() {
+
+	mStorage->data.swap(data);
+	mStorage->count = 1;
+
+	mData = mStorage->data.data();
+	mSize = mStorage->data.size();
+
+}
+
+SharedBuffer::SharedBuffer(const char* data, const size_t size)
+	: mStorage()
+	, mData(size ? data : NULL)
+	, mSize(size) {}
+
+SharedBuffer::SharedBuffer(const SharedBuffer& buffer)
+	: mStorage(buffer.mStorage)
+	, mData(buffer.mData)
+	, mSize(buffer.mSize) {
+
+	if (mStorage)
+		++mStorage->count;
+
+}
+
+SharedBuffer& SharedBuffer::operator=(const SharedBuffer& buffer) {
+
+	// the storage is acquired before the old one is
+		// released in case both are the same
+	if (buffer.mStorage)
+		++buffer.mStorage->count;
+
+	clear();
+
+	mStorage = buffer.mStorage;
+	mData = buffer.mData;
+	mSize = buffer.mSize;
+
+	return *this;
+
+}
+
+SharedBuffer::~SharedBuffer() {
+	clear();
+}
+
+const char* SharedBuffer::getData() const {
+	return mData;
+}
+
+size_t SharedBuffer::getSize() const {
+	return mSize;
+}
+
+bool SharedBuffer::isEmpty() const {
+	return (getSize() == 0);
+}
+
+void SharedBuffer::clear() {
+
+	// the last copy deletes the storage
+	if (mStorage && --mStorage->count == 0)
+		delete mStorage;
+
+	mStorage = NULL;
+	mData = NULL;
+	mSize = 0;
+
+}
@@ -0,0 +1,70 @@
+/* this file contains the definition of the SharedBuffer class
+ * It's an immutable byte buffer whose storage is shared by all of
+ *  its copies and released when the last one is destroyed.
+ * It is used to hand the same in-memory entity body (like a cached
+ *  compressed file) to several responses without copying it, and
+ *  to keep that body alive while a response is still sending it
+ *  even if its cache entry was evicted or replaced meanwhile
+ * It can also refer to memory that it doesn't own (like a mapped
+ *  asset pack) which stays valid for the whole program
+ */
+
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+class SharedBuffer {
+
+	public:
+		/******* public member functions *******/
+		// creates an empty buffer
+		SharedBuffer();
+
+		// takes the content of data without copying it
+			// (data is left empty)
+		explicit SharedBuffer(std::string& data);
+
+		// refers to size bytes at data without copying them
+		// data isn't released by the buffer and should
+			// outlive all of its copies
+		SharedBuffer(const char* data, const size_t size);
+
+		SharedBuffer(const SharedBuffer& buffer);
+
+		SharedBuffer& operator=(const SharedBuffer& buffer);
+
+		~SharedBuffer();
+
+		// returns a pointer to the first byte
+			// or NULL if the buffer is empty
+		const char* getData() const;
+
+		size_t getSize() const;
+
+		bool isEmpty() const;
+
+		// releases the storage held by this copy
+			// and makes it empty
+		void clear();
+
+	private:
+		/******* private nested types *******/
+		// storage shared by all the copies
+			// along with the number of copies
+		struct Storage {
+			std::string data;
+			size_t count;
+		};
+
+		/******* private member objects *******/
+		// NULL if the buffer is empty or
+			// refers to memory it doesn't own
+		Storage* mStorage;
+
+		// bytes of the buffer (NULL if it's empty)
+		const char* mData;
+
+		size_t mSize;
+
+};
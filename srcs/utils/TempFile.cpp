@@ -0,0 +1,188 @@
+/* this file contains the implementation of the TempFile class */
+
+#include <TempFile.hpp>
+
+std::string TempFile::mDirectory = "/tmp";
+
+const size_t TempFile::mMemoryLimit = 1024 * 1024;
+
+const size_t TempFile::mCopySize = 65536;
+
+TempFile::TempFile()
+	: mFd(-1)
+	, mStorage(MEMORY)
+	, mSize() {}
+
+TempFile::~TempFile() {
+	close();
+}
+
+void TempFile::create(const Storage storage) {
+
+	close();
+
+	mStorage = storage;
+
+	if (storage == MEMORY)
+		mFd = createMemory();
+
+	// the memory storage isn't supported
+	if (mFd == -1) {
+		mFd = createDisk();
+		mStorage = DISK;
+	}
+
+}
+
+void TempFile::write(const char* data, const size_t size) {
+
+	if (mFd == -1)
+		throw std::runtime_error("TempFile::write(): no storage");
+
+	if (mStorage == MEMORY && mSize + size > mMemoryLimit)
+		moveToDisk();
+
+	size_t written = 0;
+	while (written < size) {
+
+		const ssize_t writtenBytes =
+			::write(mFd, data + written, size - written);
+
+		if (writtenBytes == -1) {
+			if (errno == EINTR)
+				continue;
+			throwErrnoException("TempFile::write()");
+		}
+
+		written += writtenBytes;
+
+	}
+
+	mSize += size;
+
+}
+
+size_t TempFile::getSize() const {
+
+	struct stat info;
+
+	if (mFd == -1 || fstat(mFd, &info) == -1)
+		throw std::runtime_error("TempFile::getSize(): "
+			"couldn't get the size of the storage");
+
+	return info.st_size;
+
+}
+
+int TempFile::getFd() const {
+	return mFd;
+}
+
+TempFile::Storage TempFile::getStorage() const {
+	return mStorage;
+}
+
+int TempFile::release() {
+
+	const int fd = mFd;
+
+	mFd = -1;
+	mSize = 0;
+
+	return fd;
+
+}
+
+void TempFile::close() {
+
+	if (mFd != -1)
+		::close(mFd);
+
+	mFd = -1;
+	mSize = 0;
+
+}
+
+void TempFile::setDirectory(const std::string& directory) {
+	mDirectory = directory;
+}
+
+int TempFile::createMemory() {
+
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+	// the name is only shown in /proc and doesn't
+		// have to be unique
+	return memfd_create("http-server", MFD_CLOEXEC);
+#else
+	return -1;
+#endif
+
+}
+
+int TempFile::createDisk() {
+
+#ifdef O_TMPFILE
+	// an unnamed inode in the directory
+	const int fd = open(mDirectory.c_str(),
+		O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+
+	if (fd != -1)
+		return fd;
+#endif
+
+	// the file is named for as short as possible
+	std::string path = mDirectory + "/tmp_XXXXXX";
+
+	const int namedFd = mkstemp(&path[0]);
+	if (namedFd == -1)
+		throwErrnoException("TempFile::createDisk()");
+
+	unlink(path.c_str());
+	fcntl(namedFd, F_SETFD, FD_CLOEXEC);
+
+	return namedFd;
+
+}
+
+void TempFile::moveToDisk() {
+
+	const int diskFd = createDisk();
+
+	std::vector<char> buffer(mCopySize);
+
+	off_t offset = 0;
+	ssize_t readBytes;
+
+	while ((readBytes = pread(mFd, &buffer[0], mCopySize, offset)) > 0) {
+
+		for (ssize_t written = 0; written < readBytes; ) {
+
+			const ssize_t writtenBytes = ::write(diskFd,
+				&buffer[written], readBytes - written);
+
+			if (writtenBytes == -1 && errno != EINTR) {
+				::close(diskFd);
+				throwErrnoException("TempFile::moveToDisk()");
+			}
+
+			if (writtenBytes > 0)
+				written += writtenBytes;
+
+		}
+
+		offset += readBytes;
+
+	}
+
+	if (readBytes == -1) {
+		::close(diskFd);
+		throwErrnoException("TempFile::moveToDisk()");
+	}
+
+	// the memory is freed once its descriptor is closed
+	::close(mFd);
+
+	mFd = diskFd;
+	mStorage = DISK;
+
+}
@@ -0,0 +1,117 @@
+/* this file contains the definition of the TempFile class
+ * It's an anonymous temporary storage that's only reachable through
+ *  its file descriptor: it has no name in any directory so nothing
+ *  has to be unlinked and nothing is left behind if the server
+ *  crashes. It's used for the request bodies and the outputs of the
+ *  CGI scripts, and it's passed around by descriptor
+ * A MEMORY storage is created with memfd_create() and is moved to
+ *  the disk once it grows past mMemoryLimit. A DISK storage is
+ *  created with O_TMPFILE in the temporary files directory
+ * Where these aren't supported, the storage falls back to the disk
+ *  and then to a file created with mkstemp() and unlinked at once
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <utils.hpp>
+
+class TempFile {
+
+	public:
+		/******* nested types *******/
+		// where the content of the file is kept
+		enum Storage {
+			MEMORY,
+			DISK
+		};
+
+		/******* public member functions *******/
+		TempFile();
+
+		~TempFile();
+
+		// creates a new empty storage and closes any
+			// previous one
+		// storage may end up on the disk if the
+			// memory one isn't supported
+		// throws std::runtime_error on error
+		void create(const Storage storage);
+
+		// appends size bytes of data
+		// a memory storage is moved to the disk
+			// first if it would grow past mMemoryLimit
+		// throws std::runtime_error on error
+		void write(const char* data, const size_t size);
+
+		// returns the size of the content
+			// (which may have been written by
+			// another process to the descriptor)
+		// throws std::runtime_error on error
+		size_t getSize() const;
+
+		// returns the read/write descriptor
+			// or -1 if there is no storage
+		int getFd() const;
+
+		Storage getStorage() const;
+
+		// gives up the ownership of the descriptor
+			// and returns it
+		int release();
+
+		// closes the storage which frees its content
+		void close();
+
+		// sets the directory of the disk storages
+		static void setDirectory(const std::string& directory);
+
+	private:
+		/******* private member objects *******/
+		int mFd;
+
+		Storage mStorage;
+
+		// number of bytes written with write()
+		size_t mSize;
+
+		// directory in which disk storages are created
+		static std::string mDirectory;
+
+		// size over which a memory storage
+			// is moved to the disk
+		static const size_t mMemoryLimit;
+
+		// amount of bytes copied at once
+			// when a storage is moved
+		static const size_t mCopySize;
+
+		/******* private member functions *******/
+		// copying would close the same
+			// descriptor twice
+		TempFile(const TempFile&);
+
+		TempFile& operator=(const TempFile&);
+
+		// returns a memory storage descriptor
+			// or -1 if it isn't supported
+		static int createMemory();
+
+		// returns a disk storage descriptor
+		// throws std::runtime_error on error
+		static int createDisk();
+
+		// copies the content of the memory storage
+			// to a new disk storage that replaces it
+		// throws std::runtime_error on error
+		void moveToDisk();
+
+};
@@ -0,0 +1,61 @@
+/* this file contains the implementation of the TimeCache class */
+
+#include <TimeCache.hpp>
+
+std::time_t TimeCache::mTime = 0;
+
+std::string TimeCache::mHttpDate;
+
+std::string TimeCache::mLogDate;
+
+void TimeCache::update() {
+
+	const std::time_t now = std::time(NULL);
+
+	// the representations only change every second
+	if (now == mTime)
+		return;
+
+	mTime = now;
+
+	mHttpDate = timeToHttpDate(now);
+
+	const std::tm* localTime = std::localtime(&now);
+	if (localTime == NULL) {
+		mLogDate = "[] ";
+		return;
+	}
+
+	// same format as the one that was streamed for
+		// each log line: [YYYY-M-D H:M:S]
+	char logDateBuff[64];
+	std::sprintf(logDateBuff, "[%d-%d-%d %d:%d:%d] ",
+		localTime->tm_year + 1900, localTime->tm_mon + 1,
+		localTime->tm_mday, localTime->tm_hour,
+		localTime->tm_min, localTime->tm_sec);
+
+	mLogDate = logDateBuff;
+
+}
+
+std::time_t TimeCache::getTime() {
+	init();
+	return mTime;
+}
+
+const std::string& TimeCache::getHttpDate() {
+	init();
+	return mHttpDate;
+}
+
+const std::string& TimeCache::getLogDate() {
+	init();
+	return mLogDate;
+}
+
+void TimeCache::init() {
+
+	if (mTime == 0)
+		update();
+
+}
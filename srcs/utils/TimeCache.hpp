@@ -0,0 +1,49 @@
+/* this file contains the definition of the TimeCache class
+ * It holds the current time along with its http-date and log
+ *  timestamp representations so that they are formatted at most
+ *  once per second instead of once per response or log line
+ * The event loop updates it once per iteration and every
+ *  response and log line reads the cached values
+ */
+
+#pragma once
+
+#include <string>
+#include <ctime>
+#include <cstdio>
+#include <utils.hpp>
+
+class TimeCache {
+
+	public:
+		/******* public member functions *******/
+		// reads the current time and reformats the cached
+			// representations if the second changed
+		static void update();
+
+		// returns the cached current time
+		static std::time_t getTime();
+
+		// returns the cached current time in the http-date
+			// format (example: Sun, 06 Nov 1994 08:49:37 GMT)
+		static const std::string& getHttpDate();
+
+		// returns the cached current local time in the format
+			// of log lines: [YYYY-MM-DD HH:MM:SS] followed
+			// by a space
+		static const std::string& getLogDate();
+
+	private:
+		/******* private member objects *******/
+		// 0 until the first update
+		static std::time_t mTime;
+
+		static std::string mHttpDate;
+
+		static std::string mLogDate;
+
+		/******* private member functions *******/
+		// updates the cache if it was never updated
+		static void init();
+
+};
@@ -59,11 +59,20 @@ void throwErrnoException(const std::string& context) {
 
 void makeFDNonBlock(int fd) {
 
-	if (fcntl(fd, F_SETFD, O_NONBLOCK) == -1)
+	// O_NONBLOCK is a file status flag that's
+		// added to the ones already set
+	const int flags = fcntl(fd, F_GETFL);
+
+	if (flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1)
 		throwErrnoException("failed to make FD non-blocking");
 
 }
 
+bool isRetryError() {
+	return (errno == EAGAIN || errno == EWOULDBLOCK
+		|| errno == EINTR);
+}
+
 void writeToStream(std::ostream& stream,
 	const char* str, std::streamsize count) {
 
@@ -76,6 +85,25 @@ void writeToStream(std::ostream& stream,
 
 }
 
+void writeToFd(int fd, const char* str, size_t count) {
+
+	while (count) {
+
+		const ssize_t writtenBytes = write(fd, str, count);
+
+		if (writtenBytes == -1 && errno == EINTR)
+			continue;
+
+		if (writtenBytes < 1)
+			throwErrnoException("writeToFd()");
+
+		str += writtenBytes;
+		count -= writtenBytes;
+
+	}
+
+}
+
 bool removeFile(const std::string& filePath) {
 	return (unlink(filePath.c_str()) == 0);
 }
@@ -224,6 +252,104 @@ std::string timeToStr(const std::tm* time) {
 
 }
 
+std::time_t getFileModTime(const std::string& path) {
+
+	// info about path is set by stat()
+		// in this structure
+	struct stat pathInfo;
+
+	if (stat(path.c_str(), &pathInfo)) {
+		const std::string errorMsg =
+			std::string("getFileModTime(): ")
+			+ "couldn't get info of path: '"
+			+ path + '\'';
+		throw std::runtime_error(errorMsg);
+	}
+
+	return pathInfo.st_mtime;
+
+}
+
+std::string timeToHttpDate(const std::time_t time) {
+
+	// http dates are always expressed in GMT
+	const std::tm* gmTime = std::gmtime(&time);
+
+	// an http-date is always 29 bytes long
+	char dateBuff[32];
+
+	if (gmTime == NULL || std::strftime(dateBuff,
+		sizeof(dateBuff), "%a, %d %b %Y %H:%M:%S GMT",
+		gmTime) == 0) {
+
+		return "";
+
+	}
+
+	return dateBuff;
+
+}
+
+std::time_t httpDateToTime(const std::string& date) {
+
+	// RFC 1123, RFC 850 and asctime formats
+	const char* formats[] = {
+		"%a, %d %b %Y %H:%M:%S GMT",
+		"%A, %d-%b-%y %H:%M:%S GMT",
+		"%a %b %e %H:%M:%S %Y"
+	};
+
+	for (size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); ++i) {
+
+		std::tm dateInfo;
+		std::memset(&dateInfo, 0, sizeof(dateInfo));
+
+		const char* end = strptime(date.c_str(), formats[i], &dateInfo);
+
+		// the whole date should match the format
+		if (end != NULL && *end == '\0')
+			return timegm(&dateInfo);
+
+	}
+
+	const std::string errorMsg =
+		std::string("httpDateToTime(): ")
+		+ "invalid http-date: '" + date + '\'';
+	throw std::runtime_error(errorMsg);
+
+}
+
+std::string trimWhiteSpace(const std::string& str) {
+
+	const std::string::size_type first =
+		str.find_first_not_of(" \t");
+
+	// only white space
+	if (first == std::string::npos)
+		return "";
+
+	const std::string::size_type last =
+		str.find_last_not_of(" \t");
+
+	return str.substr(first, last - first + 1);
+
+}
+
+bool isEqualNoCase(const std::string& first,
+	const std::string& second) {
+
+	if (first.size() != second.size())
+		return false;
+
+	for (std::string::size_type i = 0; i < first.size(); ++i)
+		if (std::tolower(static_cast<unsigned char>(first[i]))
+			!= std::tolower(static_cast<unsigned char>(second[i])))
+			return false;
+
+	return true;
+
+}
+
 std::string getCurrentDir() {
 
 	// creates a buffer that can hold
@@ -10,6 +10,7 @@
 
 #include <string>
 #include <cstring>
+#include <cctype>
 #include <sys/stat.h>
 #include <sys/errno.h>
 #include <sys/types.h>
@@ -43,11 +44,21 @@ void throwErrnoException(const std::string& context);
 // calls throwErrnoException() in case of error
 void makeFDNonBlock(int fd);
 
+// returns true if errno says that an I/O operation on a
+	// non-blocking descriptor should be tried again later
+	// (it would block or was interrupted)
+bool isRetryError();
+
 // writes count bytes from str to stream
 // throws std::runtime_error on error
 void writeToStream(std::ostream& stream,
 	const char* str, std::streamsize count);
 
+// writes count bytes from str to fd (retrying
+	// partial writes)
+// calls throwErrnoException() in case of error
+void writeToFd(int fd, const char* str, size_t count);
+
 // generates a unique temporary file name
 	// and appends it to pathPrefix
 // throws std::runtime_error on error
@@ -78,6 +89,29 @@ const std::tm* getLastModifiedTime
 	// example [10-Apr-2020 10:20]
 std::string timeToStr(const std::tm* time);
 
+// gets the last modified time of a file
+	// as seconds since the epoch
+// throws std::runtime_error on failure
+std::time_t getFileModTime(const std::string& path);
+
+// converts time to the http-date format (RFC 1123)
+	// example: Sun, 06 Nov 1994 08:49:37 GMT
+std::string timeToHttpDate(const std::time_t time);
+
+// converts an http-date to seconds since the epoch
+// the three formats allowed by RFC 2616 are accepted
+	// (RFC 1123, RFC 850 and asctime formats)
+// throws std::runtime_error if date is in none of them
+std::time_t httpDateToTime(const std::string& date);
+
+// returns str without its leading
+	// and trailing white space (SP/HT)
+std::string trimWhiteSpace(const std::string& str);
+
+// compares two strings ignoring the case of their letters
+bool isEqualNoCase(const std::string& first,
+	const std::string& second);
+
 // gets the full path of the current
 	// working directory
 // std::runtime_error is thrown on error
@@ -115,6 +149,17 @@ Num strToNum(const std::string& numStr) {
 
 }
 
+// converts an integral type to
+	// a hexadecimal string
+template <class Num>
+std::string decimalToHex(Num num) {
+
+	std::ostringstream converter;
+	converter << std::hex << num;
+	return (converter.str());
+
+}
+
 // converts a hexadecimal string 
 	// to an arithmetic type
 // throws std::runtime_error on error